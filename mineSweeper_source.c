@@ -4,20 +4,50 @@
  */
 
 #define _CRT_SECURE_NO_WARNINGS
+#define _GNU_SOURCE /* For accept4() and the socket flags of serveSocket(). */
 #include <stdio.h>
+#include <stdarg.h>
 #include <time.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <threads.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#endif
 
 /* Special Constants*/
+/* Below: Default dimensions, used unless others are given on the command line as "rows cols bombs". */
 #define NROWS 20 /* Would be same area and fit alphabet coordinates if 20x24 */
 #define NCOLS 24
 #define NBOMBS 99
+#define MAX_DIMENSION 30000 /* Keeps every tile index within an int and every coordinate within rand(). */
+#define ALPHABET_LENGTH 26
 
 #define TRUE 1
 #define FALSE 0
-#define IS_BOMB 1
+#define DEBUG_PRINTS FALSE /* Set to TRUE to print the mines and hints of each new game. */
 
-#define MOVE_LENGTH 10
+/* Below: Layout of one packed tile. The low nibble holds the hint. */
+#define HINT_MASK 0x0F
+#define MINE_SHIFT 4
+#define MINE_BIT (1 << MINE_SHIFT)
+#define REVEALED_BIT 0x20
+#define FLAGGED_BIT 0x40
+#define QUEUED_BIT 0x80 /* Only set while solveLogically() has the tile waiting to be examined. */
+
+#define MOVE_LENGTH 16
 #define MACT 0
 	/* Below: Used in flagRemaining calculations in playGame(). */
 	#define FIRST_MOVE -2
@@ -31,78 +61,452 @@
 #define WIN 1
 #define RESTART 2
 #define QUIT 3
+#define PLAYING 4 /* State of a served game still going on. */
+
+/* Below: Actions in a journal's move stream. */
+#define JOURNAL_SWEEP 0
+#define JOURNAL_RING_SWEEP 1
+#define JOURNAL_FLAG 2
+#define JOURNAL_END 3 /* Ends a game, with how it ended in place of the tile. */
+
+/* Below: A growable list of tile positions. */
+typedef struct {
+	int* items;
+	int count, length;
+} IntList;
+
+/* Below: The whole game state. Every tile is one byte holding its mine bit, hint, and revealed/flagged state;
+ *        the text the player sees is rendered from it one row at a time. */
+typedef struct {
+	int rows, cols, bombs;
+	int stride; /* cols + 2: Rows include the outside border, which is kept revealed and mine-free. */
+	int over; /* TRUE once showAnswer() has exposed the mines. */
+	int safeRemaining; /* Safe tiles still covered. The game is won when it reaches zero. */
+	int flags; /* Tiles currently flagged. */
+	int moves; /* Tiles swept and flags toggled through sweepTile() and toggleFlag() this game. */
+	uint64_t random; /* State of the random number stream the bombs are placed from. */
+	unsigned char* tiles;
+	char* text; /* Scratch line for renderRow(). */
+	int* pending; /* Circular queue of zero tiles revealTile() has yet to open around. */
+	int pendingLength;
+	int words; /* 64-bit words per row of planes. */
+	uint64_t* planes; /* Scratch rows of mine bits for prepareHints(). */
+	int logging; /* While TRUE, every tile revealed or flagged is added to changes. */
+	IntList changes;
+	IntList work; /* Tiles solveLogically() has yet to examine. */
+	IntList stuck; /* Tiles it has examined alone to no effect, to compare with their neighbours next. */
+	FILE* journal; /* If not NULL, where every move is appended as it is made. Owned by whoever set it. */
+	int journalFlush; /* If TRUE, every move is flushed to the journal, so a game cut off mid-way can be resumed. */
+} Board;
+
+/* Below: A journal read into memory, and how far decoding it has got. */
+typedef struct {
+	unsigned char* data;
+	size_t size, at;
+} Journal;
+
+/* Below: One connection to serveGames(), and the replies queued for it. */
+typedef struct {
+	int fd; /* -1 for standard input and output. */
+	char* input; /* MAX_LINE bytes holding the start of a command line yet to be finished. */
+	size_t inputCount;
+	char* output;
+	size_t outputCount, outputLength;
+} Client;
+
+/* Below: One game hosted by serveGames(). Its board logs every change, so each move replies with only those. */
+typedef struct {
+	Board* board; /* NULL once the game is closed. */
+	const Client* owner;
+	int state; /* PLAYING, WIN or LOSE. */
+	int dealt; /* FALSE until the first sweep places the bombs around itself. */
+} Session;
+
+typedef struct {
+	Session* sessions; /* Indexed by game number. */
+	int count;
+	size_t length;
+	IntList freeIds; /* Numbers of closed games, to reuse. */
+	uint64_t seed; /* Game n is dealt from streamSeed(seed, n). */
+	uint64_t games;
+} Server;
+
+/* Below: Shared by the threads of newNoGuessAnswer(). */
+typedef struct {
+	int* move;
+	uint64_t seed; /* Candidate layout n is dealt from streamSeed(seed, n). */
+	atomic_int next; /* Next candidate to try. */
+	atomic_int found; /* Lowest candidate found to clear without guessing so far. */
+	struct timespec deadline; /* No candidate is handed out after this. */
+} NoGuessJob;
+
+typedef struct {
+	NoGuessJob* job;
+	Board* board; /* Where this thread deals and solves its candidates. */
+} NoGuessWorker;
+
+/* Below: First-move policies for simulateGames(). */
+#define FIRST_CENTRE 0
+#define FIRST_CORNER 1
+#define FIRST_RANDOM 2
+
+/* Below: Shared by the threads of simulateGames(). */
+typedef struct {
+	uint64_t seed; /* Game n is dealt from streamSeed(seed, n). */
+	int rows, cols, bombs;
+	int firstMove;
+	long games;
+	const char* journalName; /* If not NULL, thread n journals its games to journalName.n. */
+	atomic_long next; /* First game of the next batch to hand out. */
+} SimulationJob;
+
+/* Below: One thread's share of the games, and its totals once it is done. */
+typedef struct {
+	SimulationJob* job;
+	int thread;
+	int failed; /* TRUE if the thread could not make its board, bot or journal. */
+	long games, wins;
+	long long moves, movesSquared, guesses, guessesSquared;
+	double seconds, secondsSquared; /* Spent playing, summed over the games, and the sum of its squares. */
+} SimulationWorker;
+
+/* Below: What playBot() remembers about one independent part of the frontier, keyed by the hints around it. */
+typedef struct {
+	uint64_t signature;
+	int size; /* Covered tiles in it. */
+	int exact; /* TRUE if every arrangement was counted, or FALSE if only estimates are kept. */
+	size_t offset; /* Where its counts, or estimates, start in the bot's pool. */
+} BotEntry;
+
+/* Below: One way countArrangements() can go from a state before a cell to one after it. */
+typedef struct {
+	uint64_t key; /* Bombs given so far to each rule still open, four bits apiece. */
+	int from, to; /* States before and after the cell. */
+	int value; /* 1 if it puts a bomb on the cell, or 0. */
+} BotStep;
+
+/* Below: Scratch space for playBot(), kept from game to game so that playing stops allocating once it has grown. */
+typedef struct {
+	IntList frontier; /* Revealed number tiles that may still have covered neighbours. */
+	IntList cells; /* The covered tiles next to them, sorted. */
+	IntList link; /* Per cell: its union-find parent, then its place within its component (or -1). */
+	IntList slot; /* Per cell: the component numbered for it, if it is a union-find root. */
+	IntList group; /* Per frontier tile: its component. */
+	IntList byGroup; /* Frontier tiles of each component in turn, */
+	IntList groupStart; /* starting here. */
+	IntList order; /* Cells of each component in turn, in the order they are counted, */
+	IntList orderStart; /* starting here. */
+	IntList entryOf; /* Per component: its entry in the cache. */
+	IntList cellRules; /* Per cell being counted: up to 8 of the frontier tiles (rules) it neighbours, */
+	IntList ruleCount; /* and how many. */
+	IntList need, open; /* Per rule: bombs it needs, and cells it has. */
+	IntList left, shift; /* Per rule while counting: cells not yet passed, and where its bombs sit in a key. */
+	IntList layerStart; /* Per cell: the first of the states before it. */
+	IntList stepStart; /* Per cell: the first of the steps across it. */
+	BotStep* steps;
+	size_t stepCount, stepLength;
+	uint64_t* keys; /* Per state: its key. */
+	size_t keyLength;
+	double* tallies; /* Per state: arrangements reaching it, then arrangements finishing from it, by bombs. */
+	size_t tallyLength;
+	BotEntry* entries;
+	int entryCount;
+	size_t entryLength;
+	double* pool; /* Arrangement counts of cached components. */
+	size_t poolCount, poolLength;
+	double* product; /* Scratch polynomials for combining components, all in the block product points to. */
+	double* others;
+	double* spread;
+	double* weight;
+	size_t polyLength;
+	int guesses; /* Moves this game made without knowing they were safe. */
+} Bot;
+
+#define TILE(board, row, col) ((board)->tiles[(size_t)(row) * (board)->stride + (col)])
 
 /* Function prototypes */
-void resetBoard(char board[][NCOLS + 4]);
-int userInputInvalid(int board, char action, int row, int col, int move[]);
+Board* newBoard(int rows, int cols, int bombs);
+Board* allocateBoard(int rows, int cols, int bombs);
+void freeBoard(Board* board);
+void resetBoard(Board* board);
+int userInputInvalid(const Board* board, char action, int row, int col, int move[]);
 void printHelp(void);
-int getMove(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int move[]);
-int introSequence(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int highScore, int move[]);
+int parseCoordinates(const char userInput[], int* row, int* col);
+int getMove(Board* board, int move[]);
+int introSequence(Board* board, int highScore, int move[]);
+
+int pushInt(IntList* list, int item);
+int growPending(Board* board, int head);
+void revealTile(Board* board, int index);
+int sweepTile(Board* board, int row, int col);
+int ringSweep(Board* board, int row, int col);
+int toggleFlag(Board* board, int row, int col);
+
+uint64_t nextRandom(uint64_t* random);
+uint64_t streamSeed(uint64_t seed, uint64_t stream);
+int randomCoordinate(uint64_t* random, int range);
+void newAnswer(Board* board, int move[]);
+
+int sumAdjacent(const Board* board, int row, int col);
+void prepareHintsBySum(Board* board);
+void packMineRow(const Board* board, int row, uint64_t bits[]);
+void prepareHints(Board* board);
+int benchmarkHints(int rows, int cols, int bombs);
 
-void resetIntegerArray(int array[][NCOLS + 2]);
-int randomCoordinate(int range);
-void newAnswer(int answer[][NCOLS + 2], int move[]);
+int countBits(uint64_t bits);
+void queueAround(Board* board, int index);
+uint64_t coveredAround(const Board* board, int row, int col, int dRow, int dCol, int* mines);
+void settleTiles(Board* board, int row, int col, uint64_t safe, uint64_t mines);
+int examineTile(Board* board, int index, int pairs);
+void startSolving(Board* board);
+void deduceAll(Board* board, IntList* frontier);
+void stopSolving(Board* board);
+int solveLogically(Board* board, int row, int col);
+int countCores(void);
+int isPast(const struct timespec* when);
+int noGuessWorker(void* worker);
+int newNoGuessAnswer(Board* board, int move[], int threads);
+int benchmarkNoGuess(int rows, int cols, int bombs);
 
-int sumAdjacent(int answer[][NCOLS + 2], int row, int col);
-void prepareHints(int answer[][NCOLS + 2], int hints[][NCOLS + 2]);
+Bot* newBot(void);
+void freeBot(Bot* bot);
+int sizeInts(IntList* list, int count);
+void* growArray(void* array, size_t* length, size_t needed, size_t size);
+int compareInts(const void* first, const void* second);
+int findCell(const Bot* bot, int index);
+int findRoot(Bot* bot, int cell);
+int groupFrontier(Board* board, Bot* bot);
+int compareSteps(const void* first, const void* second);
+int countArrangements(Bot* bot, int size, int rules, double* counts);
+int countComponent(Board* board, Bot* bot, int component);
+int multiplyInto(Bot* bot, double* result, int length, const double* factor, int factorLength);
+int pickInterior(Board* board, const Bot* bot);
+int probeFrontier(Board* board, Bot* bot);
+int playBot(Board* board, Bot* bot, int row, int col);
+int benchmarkBot(int rows, int cols, int bombs);
+void placeFirstMove(const SimulationJob* job, Board* board, int move[]);
+int simulationWorker(void* worker);
+double meanInterval(double sum, double sumSquared, long count);
+int simulateGames(int rows, int cols, int bombs, long games, uint64_t seed, int firstMove, const char* journalName);
 
-void printBoardToScreen(char board[][NCOLS + 4]);
-int showAnswer(int answer[][NCOLS + 2], char board[][NCOLS + 4]);
-int playGame(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int move[]);
+char coordinateLabel(int index);
+char tileChar(const Board* board, unsigned char tile);
+char* renderRow(const Board* board, int row);
+void printBoardToScreen(const Board* board);
+int showAnswer(Board* board);
+int playGame(Board* board, int move[]);
 
-void saveBoardToFile(char board[][NCOLS + 4], int score, int trueBombsRemaining);
+void saveBoardToFile(const Board* board, int score, int trueBombsRemaining);
+void writeVarint(FILE* file, uint64_t value);
+void journalGame(Board* board, uint64_t seed);
+void journalMove(Board* board, int action, int row, int col);
+void journalEnd(Board* board, int result);
+int loadJournal(Journal* journal, const char* fileName);
+int readVarint(Journal* journal, uint64_t* value);
+int atGameStart(const Journal* journal);
+int readJournalGame(Journal* journal, Board** board, uint64_t* seed);
+int replayMoves(Journal* journal, Board* board, int* recorded);
+int replayJournal(const char* fileName);
+Board* resumeJournal(const char* fileName, Board* board);
+
+int appendText(Client* client, const char* format, ...);
+const char* stateName(const Session* session);
+Session* findSession(Server* server, Client* client, int id);
+void closeSession(Server* server, int id);
+void moveSession(Server* server, Client* client, Session* session, int id, char action, int row, int col);
+void handleCommand(Server* server, Client* client, const char* line);
+void dropSessions(Server* server, const Client* client);
+int serveStream(Server* server);
+#ifdef __linux__
+int flushClient(int poller, Client* client);
+void dropClient(Server* server, int poller, Client* client);
+int readClient(Server* server, Client* client);
+int serveSocket(Server* server, const char* path);
+#endif
+int serveGames(const char* path, uint64_t seed);
 
 /* Debug functions. */
-void printIntegerArray(int hints[][NCOLS + 2]);
+void printTileArray(const Board* board, int mask, int shift);
 
-int main(void) {
+int main(int argc, char* argv[]) {
 	int result = 0, startTime = 0, endTime = 0;
 	int score = 0, highScore = 0, playAgain = 0;
 	int trueBombsRemaining = 0;
 	int saveBoard = 0;
+	int rows = NROWS, cols = NCOLS, bombs = NBOMBS;
+	int bench = FALSE, noGuess = FALSE, bot = FALSE, firstMove = FIRST_CENTRE;
+	long games = 0;
+	uint64_t seed = (uint64_t)time(NULL);
+	const char* journalName = NULL;
+	const char* socketPath = NULL;
+	int resume = FALSE, resumed = FALSE, serve = FALSE;
 
-	/* Below: Contains ones in the coordinates of bombs and zero elsewhere. Constant throughout each game. */
-	int answer[NROWS + 2][NCOLS + 2] = { 0 };
-	/* Below: Contains the number of adjacent tiles containing bombs. Constant throughout game. */
-	int hints[NROWS + 2][NCOLS + 2] = { 0 };
-	/* Below: Contains the 2D string visible to the player. */
-	char board[NROWS + 2][NCOLS + 4] = { 0 };
+	/* Below: Contains the mines, hints, and what the player has uncovered or flagged. */
+	Board* board = NULL;
 	/* Below: Contains the action and coordinate of the user's choice on the current move. */
 	int move[MOVE_LENGTH] = { 0 };
-	
+
+	/* Below: "-bench" times and checks hint generation instead of starting a game, and "-noguess" only deals
+	 *        boards that can be cleared from the first move without guessing (or times dealing them, with "-bench").
+	 *        "-bench -bot" times the built-in player instead. "-simulate games" plays that many games with it on
+	 *        every core and reports the statistics, from the master seed of "-seed" and first moves by "-first".
+	 *        "-journal file" appends every game played to a binary journal, "-resume file" does too after picking up
+	 *        the game last quit from in it, and "-replay file" replays every game in one without rendering them.
+	 *        "-serve" hosts games for other programs over standard input and output, and "-socket path" on a socket. */
+	while (argc > 1 && argv[1][0] == '-') {
+		if (strcmp(argv[1], "-bench") == 0) {
+			bench = TRUE;
+		}
+		else if (strcmp(argv[1], "-noguess") == 0) {
+			noGuess = TRUE;
+		}
+		else if (strcmp(argv[1], "-bot") == 0) {
+			bot = TRUE;
+		}
+		else if (argc > 2 && strcmp(argv[1], "-simulate") == 0) {
+			games = atol(argv[2]);
+			argv[1] = argv[0];
+			argc--;
+			argv++;
+		}
+		else if (argc > 2 && strcmp(argv[1], "-seed") == 0) {
+			seed = strtoull(argv[2], NULL, 0);
+			argv[1] = argv[0];
+			argc--;
+			argv++;
+		}
+		else if (argc > 2 && (strcmp(argv[1], "-journal") == 0 || strcmp(argv[1], "-resume") == 0)) {
+			resume = strcmp(argv[1], "-resume") == 0;
+			journalName = argv[2];
+			argv[1] = argv[0];
+			argc--;
+			argv++;
+		}
+		else if (strcmp(argv[1], "-serve") == 0) {
+			serve = TRUE;
+		}
+		else if (argc > 2 && strcmp(argv[1], "-socket") == 0) {
+			serve = TRUE;
+			socketPath = argv[2];
+			argv[1] = argv[0];
+			argc--;
+			argv++;
+		}
+		else if (argc > 2 && strcmp(argv[1], "-replay") == 0) {
+			return replayJournal(argv[2]);
+		}
+		else if (argc > 2 && strcmp(argv[1], "-first") == 0) {
+			firstMove = strcmp(argv[2], "corner") == 0 ? FIRST_CORNER : strcmp(argv[2], "random") == 0 ? FIRST_RANDOM : FIRST_CENTRE;
+			argv[1] = argv[0];
+			argc--;
+			argv++;
+		}
+		else {
+			break;
+		}
+		argv[1] = argv[0];
+		argc--;
+		argv++;
+	}
+	if (argc == 4) {
+		rows = atoi(argv[1]);
+		cols = atoi(argv[2]);
+		bombs = atoi(argv[3]);
+	}
+	else if (argc != 1) {
+		printf("Usage: %s [-bench [-noguess | -bot]] [-noguess] [-simulate games [-seed seed] [-first centre | corner | random]]"
+			" [-journal file | -resume file | -replay file] [-serve | -socket path] [rows cols bombs]\n", argv[0]);
+		return 1;
+	}
+	if (serve) {
+		return serveGames(socketPath, seed);
+	}
+	if (games > 0) {
+		return simulateGames(rows, cols, bombs, games, seed, firstMove, journalName);
+	}
+	if (bench) {
+		return bot ? benchmarkBot(rows, cols, bombs) : noGuess ? benchmarkNoGuess(rows, cols, bombs) : benchmarkHints(rows, cols, bombs);
+	}
+	board = newBoard(rows, cols, bombs);
+	if (board != NULL && resume) {
+		/* Below: The resumed game keeps its own size, and so do the games after it. */
+		board = resumeJournal(journalName, board);
+		resumed = board != NULL;
+		if (!resumed) {
+			printf("There is no unfinished game in %s to resume, so here is a new one.\n", journalName);
+			board = newBoard(rows, cols, bombs);
+		}
+	}
+	if (board == NULL) {
+		return 1;
+	}
+	board->random = (uint64_t)time(NULL);
+	if (journalName != NULL) {
+		board->journal = fopen(journalName, "ab");
+		if (board->journal == NULL) {
+			printf("Error: Could not open the journal %s, so this session will not be recorded.\n", journalName);
+		}
+		board->journalFlush = TRUE;
+	}
+
 	do {
 		/* Clean slate and initialize new game board. */
 		playAgain = FALSE;
-		srand((unsigned)time(NULL));
-		resetBoard(board);
-		move[MACT] = FIRST_MOVE;
 		result = WIN;
 		saveBoard = 0;
-		startTime = introSequence(answer, hints, board, highScore, move);
-		newAnswer(answer, move);
-		prepareHints(answer, hints);
+		if (resumed) {
+			resumed = FALSE;
+			move[MACT] = SWEEP;
+			move[MSBO] = FALSE;
+			startTime = (int)time(NULL);
+			printf("Welcome back! Picking up where you left off.\n");
+		}
+		else {
+			resetBoard(board);
+			move[MACT] = FIRST_MOVE;
+			startTime = introSequence(board, highScore, move);
+			seed = board->random;
+			if (noGuess && !newNoGuessAnswer(board, move, countCores())) {
+				printf("No layout that avoids guessing turned up in time, so this one may need some luck.\n");
+			}
+			else if (!noGuess) {
+				newAnswer(board, move);
+			}
+			prepareHints(board);
 
-		/* Debugging prepareHints(). */
-		printIntegerArray(answer);
-		printIntegerArray(hints);
+			/* Debugging prepareHints(). */
+			if (DEBUG_PRINTS) {
+				printTileArray(board, MINE_BIT, MINE_SHIFT);
+				printTileArray(board, HINT_MASK, 0);
+			}
 
-		board[move[MROW]][move[MCOL]] = hints[move[MROW]][move[MCOL]] + '0';
+			journalGame(board, seed);
+			sweepTile(board, move[MROW], move[MCOL]);
+		}
 
 		/* Enter main game loop. */
-		result = playGame(answer, hints, board, move);
+		result = playGame(board, move);
 
 		if (result == QUIT) {
+			/* Below: Quitting only suspends the game in the journal, for "-resume" to pick up. */
+			journalEnd(board, QUIT);
+			if (board->journal != NULL) {
+				fclose(board->journal);
+			}
+			freeBoard(board);
 			return 0;
 		}
 		if (result == RESTART) {
+			journalEnd(board, RESTART);
 			playAgain = TRUE;
 		}
 		else {
-			/* Check if the player really won. */
-			trueBombsRemaining = showAnswer(answer, board);
-			if (trueBombsRemaining > 0) {
+			/* Check if the player really won: every safe tile is uncovered, or else every bomb is flagged. */
+			trueBombsRemaining = showAnswer(board);
+			if (board->safeRemaining > 0 && trueBombsRemaining > 0) {
 				result = LOSE;
 			}
+			journalEnd(board, result);
 
 			/* Game over sequence. */
 			endTime = (int)time(NULL);
@@ -135,41 +539,110 @@ int main(void) {
 	} while (playAgain == TRUE);
 
 	/* Unneccessary closing code. */
+	if (board->journal != NULL) {
+		fclose(board->journal);
+	}
+	freeBoard(board);
 	system("PAUSE");
 	return 0;
 }
 
-#define BLANK '.'
-#define CORNER '+'
-/* Purpose: Resets the character array visible to the player for a new game.
+#define PLANE_ROWS 5 /* Three rows of mines for prepareHints(), then two of column sums. */
+#define SPAWN_RADIUS 1
+#define SPAWN_AREA ((2 * SPAWN_RADIUS + 1) * (2 * SPAWN_RADIUS + 1))
+/* Purpose: Allocates a board of the given size, one byte per tile plus a one-tile border.
+ * Return:  The new board, or NULL (after printing why) if the size or bomb count is unusable.
  */
-void resetBoard(char board[][NCOLS + 4]) {
-	int atRow = 0, atCol = 0;
+Board* newBoard(int rows, int cols, int bombs) {
+	Board* board = NULL;
 
-	/* Fills the borders with coordinate values */
-	for (atRow = 0; atRow < NROWS; atRow++) {
-		board[atRow + 1][0] = board[atRow + 1][NCOLS + 1] = atRow + 'A';
+	if (rows < 1 || rows > MAX_DIMENSION || cols < 1 || cols > MAX_DIMENSION) {
+		printf("Error: Boards must have between 1 and %d rows and columns.\n", MAX_DIMENSION);
+		return NULL;
 	}
-	for (atCol = 0; atCol < NCOLS; atCol++) {
-		board[0][atCol + 1] = board[NROWS + 1][atCol + 1] = atCol + 'A';
+	/* Below: Leaves room to keep the area around the first move clear. */
+	if (bombs < 1 || bombs > rows * cols - SPAWN_AREA) {
+		printf("Error: A %dx%d board holds between 1 and %d bombs.\n", rows, cols, rows * cols - SPAWN_AREA);
+		return NULL;
 	}
 
-	/* Fills the body of the board with BLANK. */
-	for (atRow = 0; atRow < NROWS; atRow++) {
-		for (atCol = 0; atCol < NCOLS; atCol++) {
-			board[atRow + 1][atCol + 1] = BLANK;
+	board = allocateBoard(rows, cols, bombs);
+	if (board == NULL) {
+		printf("Error: Not enough memory for a %dx%d board.\n", rows, cols);
+	}
+	return board;
+}
+
+/* Purpose: Does the work of newBoard() without checking the size or printing anything, for callers such as
+ *          handleCommand() that check it themselves and answer in their own way.
+ * Return:  The new board, or NULL if memory ran out.
+ */
+Board* allocateBoard(int rows, int cols, int bombs) {
+	Board* board = NULL;
+
+	board = malloc(sizeof(Board));
+	if (board != NULL) {
+		board->rows = rows;
+		board->cols = cols;
+		board->bombs = bombs;
+		board->stride = cols + 2;
+		board->over = FALSE;
+		board->safeRemaining = 0;
+		board->flags = 0;
+		board->random = 0;
+		board->journal = NULL;
+		board->journalFlush = FALSE;
+		board->logging = FALSE;
+		board->changes.items = board->work.items = board->stuck.items = NULL;
+		board->changes.count = board->work.count = board->stuck.count = 0;
+		board->changes.length = board->work.length = board->stuck.length = 0;
+		board->pending = NULL;
+		board->pendingLength = 0;
+		board->words = (board->stride + 63) / 64;
+		board->tiles = malloc((size_t)(rows + 2) * board->stride);
+		board->text = malloc((size_t)board->stride + 2);
+		board->planes = malloc((size_t)PLANE_ROWS * board->words * sizeof(uint64_t));
+		if (board->tiles == NULL || board->text == NULL || board->planes == NULL) {
+			freeBoard(board);
+			board = NULL;
 		}
 	}
+	return board;
+}
 
-	/* Fills the column past the right border of the board with 'newline' characters,
-	 * and the (last) column further right with NULL characters. */
-	for (atRow = 0; atRow < NROWS + 2; atRow++) {
-		board[atRow][NCOLS + 2] = '\n';
-		board[atRow][NCOLS + 3] = '\0';
+/* Purpose: Releases a board from newBoard().
+ */
+void freeBoard(Board* board) {
+	if (board != NULL) {
+		free(board->tiles);
+		free(board->text);
+		free(board->pending);
+		free(board->planes);
+		free(board->changes.items);
+		free(board->work.items);
+		free(board->stuck.items);
+		free(board);
 	}
+}
+
+#define BLANK '.'
+#define CORNER '+'
+/* Purpose: Clears every tile for a new game.
+ * Note:    Border tiles are marked revealed so sweeps never spill onto them.
+ */
+void resetBoard(Board* board) {
+	int atRow = 0;
 
-	/* Fills in the corners so it prints properly. */
-	board[0][0] = board[0][NCOLS + 1] = board[NROWS + 1][0] = board[NROWS + 1][NCOLS + 1] = CORNER;
+	memset(board->tiles, REVEALED_BIT, (size_t)board->stride);
+	for (atRow = 1; atRow < board->rows + 1; atRow++) {
+		memset(&TILE(board, atRow, 1), 0, (size_t)board->cols);
+		TILE(board, atRow, 0) = TILE(board, atRow, board->cols + 1) = REVEALED_BIT;
+	}
+	memset(&TILE(board, board->rows + 1, 0), REVEALED_BIT, (size_t)board->stride);
+	board->over = FALSE;
+	board->safeRemaining = 0;
+	board->flags = 0;
+	board->moves = 0;
 }
 
 #define FLAG_CHAR 'F'
@@ -179,45 +652,51 @@ void resetBoard(char board[][NCOLS + 4]) {
 #define RESTART_CHAR 'R'
 #define QUIT_CHAR 'Q'
 /* Purpose: Checks if the user's move input command is invalid. If so, prints an explanation and re-prompt.
- * Param:   userInput[] - The string containing the user's command from getMove().
+ * Param:   action, row, col - The user's command from getMove(), with coordinates counting the border as zero.
  * Param:   move[] - Address comes from main(). Used to check whether it is the first move.
  * Return:  TRUE if the user's move is invalid, or FALSE otherwise.
  */
-int userInputInvalid(int board, char action, int row, int col, int move[]) {
-	/* Below: return TRUE if either: the player is trying to restart or quit on the first move,
+int userInputInvalid(const Board* board, char action, int row, int col, int move[]) {
+	unsigned char tile = 0;
+
+	/* Below: return TRUE if either: action is none of flag, sweep, restart, or quit, */
+	if (action != SWEEP_CHAR && action != RING_SWEEP_CHAR && action != FLAG_CHAR &&
+		action != RESTART_CHAR && action != QUIT_CHAR) {
+		printf("Error: The action was neither %c, %c, %c, %c, nor %c. Please try again\n", SWEEP_CHAR, RING_SWEEP_CHAR, FLAG_CHAR, RESTART_CHAR, QUIT_CHAR);
+		return TRUE;
+	}
+	/* Cont. or the player is trying to restart or quit on the first move,
 	 * (Only allows player to restart or quit after first move since the first call to
 	 * getMove() is inside introSequence(), which cannot return this type of result to main()). */
-	if (move[MACT] == FIRST_MOVE && (action == RESTART_CHAR || action == QUIT_CHAR)) {
-		printf("Error: You cannot resart or quit on your first move. Please try again.\n");
-		return TRUE;
+	if (action == RESTART_CHAR || action == QUIT_CHAR) {
+		if (move[MACT] == FIRST_MOVE) {
+			printf("Error: You cannot resart or quit on your first move. Please try again.\n");
+			return TRUE;
+		}
+		return FALSE;
 	}
-	/* Cont. or one of the coordinates is not within the boundaries defined by the special constants, */
-	if ((row - 1 < 0 || row - 1 >= NROWS) ||
-		(col - 1 < 0 || col - 1 >= NCOLS)) {
+	/* Cont. or one of the coordinates is not within the boundaries of the board, */
+	if ((row - 1 < 0 || row - 1 >= board->rows) ||
+		(col - 1 < 0 || col - 1 >= board->cols)) {
 		printf("Error: The coordinates you specified were not in the range of the board.\nPlease try again.\n");
 		return TRUE;
 	}
+	tile = TILE(board, row, col);
 	/*  Cont. or the user is trying to sweep a tile other than a BLANK, */
-	if (action == SWEEP_CHAR && board != BLANK) {
+	if (action == SWEEP_CHAR && (tile & (REVEALED_BIT | FLAGGED_BIT))) {
 		printf("Error: You cannot sweep a number tile or a flagged tile. Please try again.\n");
 		return TRUE;
 	}
 	/*  Cont. or the user is trying to ring-sweep a tile other than a number tile, */
-	if (action == RING_SWEEP_CHAR && (board < '0' || board > '8')) {
+	if (action == RING_SWEEP_CHAR && !(tile & REVEALED_BIT)) {
 		printf("Error: You cannot ring-sweep a non-number tile. Please try again.\n");
 		return TRUE;
 	}
-	/* Cont. or the user is trying to flag a tile that is neither a BLANK nor a FLAGGED, */
-	if (action == FLAG_CHAR && (board != BLANK && board != FLAGGED_CHAR)) {
+	/* Cont. or the user is trying to flag a tile that is neither a BLANK nor a FLAGGED. */
+	if (action == FLAG_CHAR && (tile & REVEALED_BIT)) {
 		printf("Error: You cannot flag an uncovered number tile. Please try again.\n");
 		return TRUE;
 	}
-	/* Cont. or action is none of flag, sweep, restart, or quit, */
-	if (action != SWEEP_CHAR && action != RING_SWEEP_CHAR && action != FLAG_CHAR &&
-		action != RESTART_CHAR && action != QUIT_CHAR) {
-		printf("Error: The action was neither %c, %c, %c, %c, nor %c. Please try again\n", SWEEP_CHAR, RING_SWEEP_CHAR, FLAG_CHAR, RESTART_CHAR, QUIT_CHAR);
-		return TRUE;
-	}
 	return FALSE;
 }
 
@@ -227,10 +706,31 @@ int userInputInvalid(int board, char action, int row, int col, int move[]) {
 void printHelp(void) {
 	printf("Controls:\n");
 	printf("Please enter a coordinate (action, row letter, column letter) for your next move.\n");
+	printf("On boards wider or taller than the alphabet, enter the row and column as numbers from 1 instead (ex. %c12.40).\n", SWEEP_CHAR);
 	printf("Actions: %c will denote a flag, and %c will denote uncovering a tile (ex. %cAA).\n", FLAG_CHAR, SWEEP_CHAR, SWEEP_CHAR);
 	printf("Additionally, the action %c will denote a 'ring-sweep,' which sweeps every blank tile adjacent to the coordinate specified.\n", RING_SWEEP_CHAR);
 	printf("Alternatively, after the first move, enter %c to restart the game board or enter %c to exit the program.\n", RESTART_CHAR, QUIT_CHAR);
-	printf("Enter %c as the fourth character in your command to suppress printing the board once.\n\n", SUPPRESS_BOARD_ONCE_CHAR);
+	printf("Enter %c right after the coordinates in your command to suppress printing the board once.\n\n", SUPPRESS_BOARD_ONCE_CHAR);
+}
+
+/* Purpose: Reads the coordinates of a move command, either two letters (ex. SAB) or two numbers (ex. S1.2).
+ *          Both count from 1, leaving zero for the border.
+ * Return:  The index of the first character after the coordinates.
+ */
+int parseCoordinates(const char userInput[], int* row, int* col) {
+	int length = 0;
+
+	if (userInput[MROW] >= 'A' && userInput[MROW] <= 'Z') {
+		*row = userInput[MROW] - 'A' + 1;
+		*col = userInput[MCOL] - 'A' + 1;
+		return MSBO;
+	}
+	if (sscanf(&userInput[MROW], "%d.%d%n", row, col, &length) == 2) {
+		return MROW + length;
+	}
+	/* Below: Neither form, so report the move as out of range. */
+	*row = *col = 0;
+	return MROW;
 }
 
 #define HELP_CHAR 'H'
@@ -240,42 +740,40 @@ void printHelp(void) {
  * Return:  returns LOSE if the player tries to sweep a bomb,
  *          RESTART if the player wants to start a new game,
  *          QUIT if the player wishes to quit the session and exit the program,
- *          and otherwise returns zero.
- * NOTE:    Passes action to playGame() for it to decide whether to increment/decrement/leave-as-is 
+ *          and otherwise returns one.
+ * NOTE:    Passes action to playGame() for it to decide whether to increment/decrement/leave-as-is
  *          flagsRemaining via the zeroth index of move[]. If move[MS(uppress)B(oard)O(nce)] is TRUE,
  *          playGame() will not print the board to the screen for that turn.
  */
-int getMove(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int move[]) {
-	int index = 0;
+int getMove(Board* board, int move[]) {
 	char userInput[MOVE_LENGTH] = { 0 };
 	int row = 0, col = 0; /* Used for each entered coordinate. */
-	int atRow = 0, atCol = 0; /* Used to conduct a ring-sweep. */
-	int numFlagsAdjacent = 0;
+	int suppressAt = MSBO; /* Index of the optional SUPPRESS_BOARD_ONCE_CHAR. */
 	move[MSBO] = FALSE; /* Reset MSBO. */
 
 	printf("Your move! (Enter 'H' for help): ");
 	/* Code to continuously prompt and check for a valid move. */
 	do {
-		scanf("%9s", userInput);
+		scanf("%15s", userInput);
 
 		/* Checks special case of whether the user needs help with controls, or wants to restart or quit the game. */
 		if (userInput[MACT] == HELP_CHAR) {
 			printHelp();
-			scanf("%9s", userInput);
+			scanf("%15s", userInput);
 		}
-		row = userInput[MROW] - 'A' + 1;
-		col = userInput[MCOL] - 'A' + 1;
-	} while (userInputInvalid(board[row][col], userInput[MACT], row, col, move));
+		suppressAt = parseCoordinates(userInput, &row, &col);
+	} while (userInputInvalid(board, userInput[MACT], row, col, move));
 
-	/* Code to translate a user move from characters to integers for safe initialization.
-	 * Only used when generating the answer array and when displaying the starting move in playGame(). */
+	if (userInput[suppressAt] == SUPPRESS_BOARD_ONCE_CHAR) {
+		move[MSBO] = TRUE;
+	}
+	/* Code to remember the first move for generating the answer. Nothing is revealed until
+	 * main() has placed the bombs around it. */
 	if (move[MACT] == FIRST_MOVE) {
 		move[MROW] = row;
 		move[MCOL] = col;
 		move[MACT] = SWEEP;
-	}
-	if (userInput[MSBO] == SUPPRESS_BOARD_ONCE_CHAR) {
-		move[MSBO] = TRUE;
+		return 1;
 	}
 	if (userInput[MACT] == RESTART_CHAR) {
 		return RESTART;
@@ -285,55 +783,15 @@ int getMove(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS
 	}
 
 	/* Execute valid modification of board on following (non-first) moves. */
-	else {
-		/* Check basic lose condition of whether player swept/ring-swept a bomb. */
-		if (userInput[MACT] == SWEEP_CHAR && answer[row][col] == IS_BOMB) {
-			move[MACT] = SWEEP;
-			return LOSE;
-		}
-
-		else if (userInput[MACT] == RING_SWEEP_CHAR) {
-			for (atRow = -1; atRow < 2; atRow++) {
-				for (atCol = -1; atCol < 2; atCol++) {
-					if (board[row + atRow][col + atCol] == FLAGGED_CHAR) {
-						numFlagsAdjacent++;
-					}
-				}
-			}
-			if (sumAdjacent(answer, row, col) - numFlagsAdjacent > 0) {
-				move[MACT] = SWEEP;
-				return LOSE;
-			}
-		}
-
-		/* Reveal a safely swept hint. */
-		if (userInput[MACT] == SWEEP_CHAR) {
-			board[row][col] = hints[row][col] + '0';
-			move[MACT] = SWEEP;
-		}
-		/* Reveal safely ring-swep hints.*/
-		if (userInput[MACT] == RING_SWEEP_CHAR) {
-			for (atRow = -1; atRow < 2; atRow++) {
-				for (atCol = -1; atCol < 2; atCol++) {
-					if (board[row + atRow][col + atCol] == BLANK) {
-						board[row + atRow][col + atCol] = hints[row + atRow][col + atCol] + '0';
-					}
-				}
-			}
-			move[MACT] = SWEEP;
-		}
-		else if (userInput[MACT] == FLAG_CHAR) {
-			/* Below: Flagging a blank tile. */
-			if (board[row][col] == BLANK) {
-				board[row][col] = FLAGGED_CHAR;
-				move[MACT] = -FLAG;
-			}
-			/* Below: Unflagging a flagged tile. */
-			else if (board[row][col] == FLAGGED_CHAR) {
-				board[row][col] = BLANK;
-				move[MACT] = FLAG;
-			}
-		}
+	move[MACT] = SWEEP;
+	if (userInput[MACT] == SWEEP_CHAR) {
+		return sweepTile(board, row, col);
+	}
+	else if (userInput[MACT] == RING_SWEEP_CHAR) {
+		return ringSweep(board, row, col);
+	}
+	else if (userInput[MACT] == FLAG_CHAR) {
+		move[MACT] = toggleFlag(board, row, col);
 	}
 
 	return 1;
@@ -344,7 +802,7 @@ int getMove(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS
  * Param:   highscore - the lowest time taken to beat the game in seconds in previous sessions.
  * Return:  The start time in seconds after the player chooses their starting coordinate
  */
-int introSequence(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int highScore, int move[]) {
+int introSequence(Board* board, int highScore, int move[]) {
 	int startTime = 0;
 	printf("Welcome to MineSweeper in C!\n");
 	printf("The current high score in this session is: %d seconds.\n", highScore);
@@ -354,186 +812,2479 @@ int introSequence(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][
 	printHelp();
 	printf("Enter a starting coordinate for this game!\n");
 	/* Below: This first move will be used to generate a valid answer array. */
-	getMove(answer, hints, board, move);
+	getMove(board, move);
 	startTime = (int)time(NULL);
 
 	printf("Good luck!\n\n");
 	return startTime;
 }
 
-/* Purpose: Used to clear the answer and hints arrays before filling with new entries.
- * Param:   array[][] - The array to clear.
+#define MIN_PENDING 1024
+/* Purpose: Appends an item to a list, growing it as needed.
+ * Return:  TRUE on success, or FALSE if there is no memory left for it.
+ */
+int pushInt(IntList* list, int item) {
+	int length = 0;
+	int* grown = NULL;
+
+	if (list->count == list->length) {
+		length = list->length < MIN_PENDING ? MIN_PENDING : 2 * list->length;
+		grown = realloc(list->items, (size_t)length * sizeof(int));
+		if (grown == NULL) {
+			return FALSE;
+		}
+		list->items = grown;
+		list->length = length;
+	}
+	list->items[list->count++] = item;
+	return TRUE;
+}
+
+/* Purpose: Doubles the queue used by revealTile() once it is full, keeping its entries in order.
+ * Param:   head - Where the oldest entry sits. Entries before it have wrapped around to the start.
+ * Return:  TRUE on success, or FALSE if there is no memory left for it.
+ */
+int growPending(Board* board, int head) {
+	int length = board->pendingLength < MIN_PENDING ? MIN_PENDING : 2 * board->pendingLength;
+	int* grown = realloc(board->pending, (size_t)length * sizeof(int));
+
+	if (grown == NULL) {
+		return FALSE;
+	}
+	/* Below: Unwraps the entries before head so they follow the rest. */
+	memcpy(&grown[board->pendingLength], grown, (size_t)head * sizeof(int));
+	board->pending = grown;
+	board->pendingLength = length;
+	return TRUE;
+}
+
+/* Purpose: Uncovers a covered, unflagged safe tile. If its hint is zero, keeps uncovering outward
+ *          until the opening is surrounded by number tiles.
+ * Param:   index - The tile's position in board->tiles.
+ * Note:    Works breadth-first through board->pending rather than recursing, so huge openings can neither
+ *          overflow the call stack nor queue more than their advancing edge. A zero tile has no adjacent bombs,
+ *          so everything it opens is safe, and the revealed border stops the spread.
+ */
+void revealTile(Board* board, int index) {
+	const int offsets[8] = { -board->stride - 1, -board->stride, -board->stride + 1, -1,
+		1, board->stride - 1, board->stride, board->stride + 1 };
+	unsigned char* tiles = board->tiles;
+	int head = 0, count = 0, at = 0, neighbour = 0, direction = 0;
+
+	if (tiles[index] & (REVEALED_BIT | FLAGGED_BIT)) {
+		return;
+	}
+	tiles[index] |= REVEALED_BIT;
+	board->safeRemaining--;
+	if (board->logging) {
+		pushInt(&board->changes, index);
+	}
+	if (tiles[index] & HINT_MASK) {
+		return;
+	}
+
+	/* Below: Every zero tile is queued exactly once, when it is uncovered. */
+	if (board->pendingLength == 0 && !growPending(board, 0)) {
+		return;
+	}
+	board->pending[count++] = index;
+	while (count > 0) {
+		at = board->pending[head];
+		if (++head == board->pendingLength) {
+			head = 0;
+		}
+		count--;
+		for (direction = 0; direction < 8; direction++) {
+			neighbour = at + offsets[direction];
+			if (tiles[neighbour] & (REVEALED_BIT | FLAGGED_BIT)) {
+				continue;
+			}
+			tiles[neighbour] |= REVEALED_BIT;
+			board->safeRemaining--;
+			if (board->logging) {
+				pushInt(&board->changes, neighbour);
+			}
+			if ((tiles[neighbour] & HINT_MASK) == 0) {
+				/* Below: Without room to remember it, the zero stays unopened for the player to ring-sweep. */
+				if (count == board->pendingLength && !growPending(board, head)) {
+					continue;
+				}
+				board->pending[(head + count) % board->pendingLength] = neighbour;
+				count++;
+			}
+		}
+	}
+}
+
+/* Purpose: Uncovers a covered tile, opening up the area around it if it has no adjacent bombs.
+ * Return:  LOSE if the tile holds a bomb, or TRUE otherwise.
+ */
+int sweepTile(Board* board, int row, int col) {
+	board->moves++;
+	journalMove(board, JOURNAL_SWEEP, row, col);
+	if (TILE(board, row, col) & MINE_BIT) {
+		return LOSE;
+	}
+	revealTile(board, row * board->stride + col);
+	return TRUE;
+}
+
+/* Purpose: Uncovers every covered, unflagged tile adjacent to (row, col).
+ * Return:  LOSE if the flags around (row, col) do not account for all of its bombs, or TRUE otherwise.
  */
-void resetIntegerArray(int array[][NCOLS + 2]) {
+int ringSweep(Board* board, int row, int col) {
+	FILE* journal = board->journal;
 	int atRow = 0, atCol = 0;
+	int numFlagsAdjacent = 0;
+
+	journalMove(board, JOURNAL_RING_SWEEP, row, col);
+
+	for (atRow = -1; atRow < 2; atRow++) {
+		for (atCol = -1; atCol < 2; atCol++) {
+			if (TILE(board, row + atRow, col + atCol) & FLAGGED_BIT) {
+				numFlagsAdjacent++;
+			}
+		}
+	}
+	if (sumAdjacent(board, row, col) - numFlagsAdjacent > 0) {
+		return LOSE;
+	}
 
-	for (atRow = 0; atRow < NROWS + 2; atRow++) {
-		for (atCol = 0; atCol < NCOLS + 2; atCol++) {
-			array[atRow][atCol] = 0;
+	/* Reveal safely ring-swept hints. The border is already revealed, so it is skipped here.
+	 * The journal already has the ring-sweep, so the sweeps it makes are left out of it. */
+	board->journal = NULL;
+	for (atRow = -1; atRow < 2; atRow++) {
+		for (atCol = -1; atCol < 2; atCol++) {
+			if (!(TILE(board, row + atRow, col + atCol) & (REVEALED_BIT | FLAGGED_BIT))) {
+				sweepTile(board, row + atRow, col + atCol);
+			}
 		}
 	}
+	board->journal = journal;
+	return TRUE;
+}
+
+/* Purpose: Flags a covered tile, or unflags a flagged one.
+ * Return:  -FLAG if a flag was placed or FLAG if one was removed, to add to flagsRemaining.
+ */
+int toggleFlag(Board* board, int row, int col) {
+	board->moves++;
+	journalMove(board, JOURNAL_FLAG, row, col);
+	TILE(board, row, col) ^= FLAGGED_BIT;
+	if (board->logging) {
+		pushInt(&board->changes, row * board->stride + col);
+	}
+	if (TILE(board, row, col) & FLAGGED_BIT) {
+		board->flags++;
+		return -FLAG;
+	}
+	board->flags--;
+	return FLAG;
+}
+
+/* Purpose: Advances a SplitMix64 stream.
+ * Return:  The next 64 random bits.
+ */
+uint64_t nextRandom(uint64_t* random) {
+	uint64_t bits = (*random += 0x9E3779B97F4A7C15ULL);
+
+	bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+	return bits ^ (bits >> 31);
+}
+
+/* Purpose: Derives the starting state of one of many independent streams from a single seed.
+ */
+uint64_t streamSeed(uint64_t seed, uint64_t stream) {
+	uint64_t state = seed ^ stream * 0xD1B54A32D192ED03ULL;
+	return nextRandom(&state);
 }
 
 /* Purpose: Generates and returns a random integer from 0 to range - 1.
  * Note:    This does not account for the outside border!
  * Return:  The random integer generated.
  */
-int randomCoordinate(int range) {
-	return rand() % range;
+int randomCoordinate(uint64_t* random, int range) {
+	return (int)((nextRandom(random) >> 32) * (uint64_t)range >> 32);
 }
 
-#define SPAWN_RADIUS 1
-/* Purpose: Generates a random distribution of #NBOMBS bombs,
- *          avoiding the player's starting coordinate.
- * Param:   answer[][] - The binary array of bomb locations.
+/* Purpose: Generates a random distribution of board->bombs bombs from board->random,
+ *          avoiding the area within SPAWN_RADIUS of the player's starting coordinate.
+ * Note:    Draws from the tiles outside that area in order, numbered 0 to eligible - 1, with Floyd's form of a
+ *          partial Fisher-Yates shuffle: the mine bits themselves record which tiles are taken, so the cost
+ *          is one draw per bomb at any density. Expects a board fresh from resetBoard().
  */
-void newAnswer(int answer[][NCOLS + 2], int move[]) {
-	int bombsPlaced = 0;
-	int row = 0, col = 0;
+void newAnswer(Board* board, int move[]) {
+	/* Below: The excluded area, clipped to the board. */
+	int top = move[MROW] - SPAWN_RADIUS < 1 ? 1 : move[MROW] - SPAWN_RADIUS;
+	int bottom = move[MROW] + SPAWN_RADIUS > board->rows ? board->rows : move[MROW] + SPAWN_RADIUS;
+	int left = move[MCOL] - SPAWN_RADIUS < 1 ? 1 : move[MCOL] - SPAWN_RADIUS;
+	int right = move[MCOL] + SPAWN_RADIUS > board->cols ? board->cols : move[MCOL] + SPAWN_RADIUS;
+	int width = right - left + 1;
+	int above = (top - 1) * board->cols; /* Eligible tiles in the rows above the area, */
+	int beside = (bottom - top + 1) * (board->cols - width); /* then in its rows, */
+	int eligible = board->rows * board->cols - (bottom - top + 1) * width; /* and in total. */
+	int drawn = 0, pick = 0, row = 0, col = 0;
 
-	/* move here has stored the user's first move from the intro sequence. */
-	resetIntegerArray(answer);
-	while (bombsPlaced < NBOMBS) {
-		row = randomCoordinate(NROWS) + 1;
-		col = randomCoordinate(NCOLS) + 1;
-		/* Below: "If at least one randomly generated coordinate component is different than the user's starting coordinate
-		 *        and the random coordinate does not already contain a bomb, place a bomb." */
-		if (((row < move[MROW] - SPAWN_RADIUS || row > move[MROW] + SPAWN_RADIUS) ||
-			 (col < move[MCOL] - SPAWN_RADIUS || col > move[MCOL] + SPAWN_RADIUS)) &&
-			answer[row][col] != IS_BOMB) {
-			/* Then, */
-			answer[row][col] = IS_BOMB;
-			bombsPlaced++;
-		}
+	for (drawn = eligible - board->bombs; drawn < eligible; drawn++) {
+		pick = randomCoordinate(&board->random, drawn + 1);
+		do {
+			/* Below: Turns the pick's number into its coordinates. */
+			if (pick < above) {
+				row = pick / board->cols + 1;
+				col = pick % board->cols + 1;
+			}
+			else if (pick < above + beside) {
+				row = (pick - above) / (board->cols - width) + top;
+				col = (pick - above) % (board->cols - width) + 1;
+				if (col >= left) {
+					col += width;
+				}
+			}
+			else {
+				row = (pick - above - beside) / board->cols + bottom + 1;
+				col = (pick - above - beside) % board->cols + 1;
+			}
+			/* Below: If the pick is already a bomb, the newest number, which cannot be, is taken instead. */
+			if (!(TILE(board, row, col) & MINE_BIT)) {
+				break;
+			}
+			pick = drawn;
+		} while (TRUE);
+		TILE(board, row, col) |= MINE_BIT;
 	}
+	board->safeRemaining = board->rows * board->cols - board->bombs;
 }
 
 /* Purpose: Returns the number of bombs adjacent to a specified coordinate of the game board.
  * Note:    Note: Function also used for coordinates of bombs, but this does not affect the game of win conditions of playGame().
- * Param:   answer[][] - Contains ones in bomb locations and zeros everywhere else.
  */
-int sumAdjacent(int answer[][NCOLS + 2], int row, int col) {
+int sumAdjacent(const Board* board, int row, int col) {
 	int atRow = -1, atCol = -1, sum = 0;
 	for (atRow = -1; atRow < 2; atRow++) {
 		for (atCol = -1; atCol < 2; atCol++) {
-			sum += answer[row + atRow][col + atCol];
+			sum += TILE(board, row + atRow, col + atCol) >> MINE_SHIFT & 1;
 		}
 	}
 	return sum;
 }
 
-/* Purpose: Clears and fills a 2D array with the full board of hints:
- *          each index contains the number of bombs in the adjacent tiles (including diagonals).
+/* Purpose: Fills the hint of every tile with the number of bombs in the adjacent tiles (including diagonals),
+ *          one tile at a time. Kept as the reference prepareHints() is checked against.
  */
-void prepareHints(int answer[][NCOLS + 2], int hints[][NCOLS + 2]) {
+void prepareHintsBySum(Board* board) {
 	int atRow = 0, atCol = 0;
 
-	resetIntegerArray(hints);
-	for (atRow = 0; atRow < NROWS; atRow++) {
-		for (atCol = 0; atCol < NCOLS; atCol++) {
-			hints[atRow + 1][atCol + 1] = sumAdjacent(answer, atRow + 1, atCol + 1);
+	for (atRow = 0; atRow < board->rows; atRow++) {
+		for (atCol = 0; atCol < board->cols; atCol++) {
+			TILE(board, atRow + 1, atCol + 1) = (TILE(board, atRow + 1, atCol + 1) & ~HINT_MASK) |
+				sumAdjacent(board, atRow + 1, atCol + 1);
 		}
 	}
 }
 
-/* Purpose: Prints the board array to the screen.
+#define LOW_BYTES 0x0101010101010101ULL
+#define GATHER_BITS 0x0102040810204080ULL
+/* Purpose: Packs the mine bits of one row, border included, into bits[]: column c becomes bit c % 64 of bits[c / 64].
+ * Note:    Gathers eight tiles per multiply, which assumes a little-endian machine, like every Windows target.
  */
-void printBoardToScreen(char board[][NCOLS + 4]) {
-	int row = 0;
+void packMineRow(const Board* board, int row, uint64_t bits[]) {
+	const unsigned char* tiles = &TILE(board, row, 0);
+	uint64_t eight = 0;
+	int atCol = 0;
 
-	printf("\n");
-	for (row = 0; row < NROWS + 2; row++) {
-		printf("%s", board[row]);
+	memset(bits, 0, (size_t)board->words * sizeof(uint64_t));
+	for (atCol = 0; atCol + 8 <= board->stride; atCol += 8) {
+		memcpy(&eight, &tiles[atCol], sizeof(eight));
+		eight = (eight >> MINE_SHIFT) & LOW_BYTES;
+		bits[atCol / 64] |= ((eight * GATHER_BITS) >> 56) << (atCol % 64);
+	}
+	for (; atCol < board->stride; atCol++) {
+		bits[atCol / 64] |= (uint64_t)(tiles[atCol] >> MINE_SHIFT & 1) << (atCol % 64);
 	}
-	printf("\n");
 }
 
-#define WRONGFLAG_CHAR '#'
-/* Purpose: Called when player game is over to modify board array to contain all bomb locations,
-            and then print the board to the screen.
- * Return:  Number of bombs missed by player.
+/* Below: spreadBits[b] has bit k of b moved to the bottom of byte k. Constant, since prepareHints() runs on many threads. */
+#define SPREAD(b) ((uint64_t)((b) & 1) | (uint64_t)((b) >> 1 & 1) << 8 | (uint64_t)((b) >> 2 & 1) << 16 \
+	| (uint64_t)((b) >> 3 & 1) << 24 | (uint64_t)((b) >> 4 & 1) << 32 | (uint64_t)((b) >> 5 & 1) << 40 \
+	| (uint64_t)((b) >> 6 & 1) << 48 | (uint64_t)((b) >> 7 & 1) << 56)
+#define SPREAD4(b) SPREAD(b), SPREAD((b) + 1), SPREAD((b) + 2), SPREAD((b) + 3)
+#define SPREAD16(b) SPREAD4(b), SPREAD4((b) + 4), SPREAD4((b) + 8), SPREAD4((b) + 12)
+#define SPREAD64(b) SPREAD16(b), SPREAD16((b) + 16), SPREAD16((b) + 32), SPREAD16((b) + 48)
+static const uint64_t spreadBits[256] = { SPREAD64(0), SPREAD64(64), SPREAD64(128), SPREAD64(192) };
+
+/* Purpose: Fills the hint of every tile with the number of bombs in the adjacent tiles (including diagonals),
+ *          matching sumAdjacent() tile for tile.
+ * Note:    Works on 64 tiles at once: each row's mines are packed into bits, added to the rows above and below
+ *          as two bit planes of column sums, and those are added to their left and right neighbours with
+ *          carry-save adders into four planes of the 0-9 count. The planes are spread back into eight hint
+ *          nibbles at a time. Border tiles keep a hint of zero.
  */
-int showAnswer(int answer[][NCOLS + 2], char board[][NCOLS + 4]) {
-	int trueBombsRemaining = 0;
-	int atRow = 0, atCol = 0;
+void prepareHints(Board* board) {
+	const int words = board->words;
+	uint64_t* above = board->planes;
+	uint64_t* middle = above + words;
+	uint64_t* below = middle + words;
+	uint64_t* low = below + words; /* Bit 0 of each column sum. */
+	uint64_t* high = low + words; /* Bit 1 of each column sum. */
+	uint64_t* spare = NULL;
+	uint64_t left0 = 0, right0 = 0, left1 = 0, right1 = 0;
+	uint64_t carry = 0, twos = 0, fours = 0, moreFours = 0;
+	uint64_t sum[4] = { 0 };
+	uint64_t eight = 0;
+	unsigned char* tiles = NULL;
+	int atRow = 0, atWord = 0, atCol = 0, plane = 0, last = 0;
 
-	/* Go through and compare answer[][] to board[][].
-	   Correct and count any true bomb location not flagged,
-	   and mark incorrect flags with WRONGFLAG_CHAR. */
-	for (atRow = 1; atRow < NROWS + 1; atRow++) {
-		for (atCol = 1; atCol < NCOLS + 1; atCol++) {
-			if (answer[atRow][atCol] == IS_BOMB && board[atRow][atCol] != FLAGGED_CHAR) {
-				board[atRow][atCol] = FLAGGED_CHAR;
-				trueBombsRemaining++;
+	packMineRow(board, 0, middle);
+	packMineRow(board, 1, below);
+	for (atRow = 1; atRow < board->rows + 1; atRow++) {
+		/* Below: Rolls the three rows down by one. */
+		spare = above;
+		above = middle;
+		middle = below;
+		below = spare;
+		packMineRow(board, atRow + 1, below);
+
+		for (atWord = 0; atWord < words; atWord++) {
+			low[atWord] = above[atWord] ^ middle[atWord] ^ below[atWord];
+			high[atWord] = (above[atWord] & middle[atWord]) | (below[atWord] & (above[atWord] ^ middle[atWord]));
+		}
+
+		tiles = &TILE(board, atRow, 0);
+		for (atWord = 0; atWord < words; atWord++) {
+			/* Below: Column sums one column to the left and one to the right of each bit. */
+			left0 = low[atWord] << 1 | (atWord > 0 ? low[atWord - 1] >> 63 : 0);
+			left1 = high[atWord] << 1 | (atWord > 0 ? high[atWord - 1] >> 63 : 0);
+			right0 = low[atWord] >> 1 | (atWord + 1 < words ? low[atWord + 1] << 63 : 0);
+			right1 = high[atWord] >> 1 | (atWord + 1 < words ? high[atWord + 1] << 63 : 0);
+
+			sum[0] = left0 ^ low[atWord] ^ right0;
+			carry = (left0 & low[atWord]) | (right0 & (left0 ^ low[atWord]));
+			twos = left1 ^ high[atWord] ^ right1;
+			fours = (left1 & high[atWord]) | (right1 & (left1 ^ high[atWord]));
+			sum[1] = twos ^ carry;
+			moreFours = twos & carry;
+			sum[2] = fours ^ moreFours;
+			sum[3] = fours & moreFours;
+
+			last = 64 * atWord + 64 < board->stride ? 64 * atWord + 64 : board->stride;
+			for (atCol = 64 * atWord; atCol + 8 <= last; atCol += 8) {
+				memcpy(&eight, &tiles[atCol], sizeof(eight));
+				eight &= ~(LOW_BYTES * HINT_MASK);
+				for (plane = 0; plane < 4; plane++) {
+					eight |= spreadBits[sum[plane] >> (atCol % 64) & 0xFF] << plane;
+				}
+				memcpy(&tiles[atCol], &eight, sizeof(eight));
 			}
-			if (board[atRow][atCol] == FLAGGED_CHAR && answer[atRow][atCol] != IS_BOMB) {
-				board[atRow][atCol] = WRONGFLAG_CHAR;
+			for (; atCol < last; atCol++) {
+				tiles[atCol] &= ~HINT_MASK;
+				for (plane = 0; plane < 4; plane++) {
+					tiles[atCol] |= (sum[plane] >> (atCol % 64) & 1) << plane;
+				}
 			}
 		}
+		tiles[0] &= ~HINT_MASK;
+		tiles[board->cols + 1] &= ~HINT_MASK;
 	}
-	printBoardToScreen(board);
-	return trueBombsRemaining;
 }
 
-/* Purpose: Loops through the main turn/move sequence until the player loses, wins, restarts, or quits.
- * Return:  LOSE if the player uncovers a bomb in answers, tentative WIN if the player uses all their flags,
- *          RESTART if the player wishes to quit the game and tell main() to start a new one, or
- *          QUIT tell main() to exit the program.
+#define BENCH_TILES 100000000.0 /* Tiles to time each version of hint generation over. */
+/* Purpose: Times prepareHints() against prepareHintsBySum() on random boards of the given size,
+ *          checking that they agree on every tile, and prints the results.
+ * Return:  Zero if they always agreed, or one otherwise.
  */
-int playGame(int answer[][NCOLS + 2], int hints[][NCOLS + 2], char board[][NCOLS + 4], int move[]) {
-	int flagsRemaining = NBOMBS; /* What the player thinks is bombsRemaining. */
-	int gameState = 0;
+int benchmarkHints(int rows, int cols, int bombs) {
+	Board* board = newBoard(rows, cols, bombs);
+	unsigned char* expected = NULL;
+	size_t size = 0;
+	int move[MOVE_LENGTH] = { 0 };
+	int rounds = 0, round = 0, mismatches = 0;
+	clock_t start = 0, bySum = 0, sliced = 0;
 
-	do {
-		/* Print the board and get the user's move.*/
-		if (move[MSBO] != TRUE) {
-			printBoardToScreen(board);
+	if (board == NULL) {
+		return 1;
+	}
+	size = (size_t)(rows + 2) * board->stride;
+	expected = malloc(size);
+	if (expected == NULL) {
+		printf("Error: Not enough memory to check a %dx%d board.\n", rows, cols);
+		freeBoard(board);
+		return 1;
+	}
+	rounds = (int)(BENCH_TILES / ((double)rows * cols)) + 1;
+	board->random = (uint64_t)time(NULL);
+
+	for (round = 0; round < rounds && mismatches == 0; round++) {
+		resetBoard(board);
+		move[MROW] = randomCoordinate(&board->random, rows) + 1;
+		move[MCOL] = randomCoordinate(&board->random, cols) + 1;
+		newAnswer(board, move);
+
+		start = clock();
+		prepareHintsBySum(board);
+		bySum += clock() - start;
+		memcpy(expected, board->tiles, size);
+
+		/* Below: Scrambles the hints so stale ones cannot pass for correct. */
+		for (move[MROW] = 1; move[MROW] < rows + 1; move[MROW]++) {
+			for (move[MCOL] = 1; move[MCOL] < cols + 1; move[MCOL]++) {
+				TILE(board, move[MROW], move[MCOL]) |= HINT_MASK;
+			}
 		}
-		printf("Bombs apparantly remaining: %d\n", flagsRemaining);
-		gameState = getMove(answer, hints, board, move);
-		if (gameState == RESTART || gameState == QUIT || gameState == LOSE) {
-			return gameState;
+		start = clock();
+		prepareHints(board);
+		sliced += clock() - start;
+
+		if (memcmp(expected, board->tiles, size) != 0) {
+			mismatches++;
 		}
-		flagsRemaining += move[MACT];
-	} while (flagsRemaining > 0);
-	/* Below: Return a tentative WIN as the result to main for main to verify. */
-	return WIN;
+	}
+
+	printf("%d board(s) of %dx%d with %d bombs:\n", round, rows, cols, bombs);
+	printf("  sumAdjacent() per tile: %8.3f ns/tile\n", 1e9 * bySum / CLOCKS_PER_SEC / ((double)rows * cols * round));
+	printf("  bit-sliced:             %8.3f ns/tile\n", 1e9 * sliced / CLOCKS_PER_SEC / ((double)rows * cols * round));
+	if (mismatches) {
+		printf("Error: The bit-sliced hints differ from sumAdjacent().\n");
+	}
+	free(expected);
+	freeBoard(board);
+	return mismatches ? 1 : 0;
 }
 
-#define FILENAME_MAX_LENGTH 20
-/* Purpose: Prompts the user for a string to use as a file name, opens a file with that name for writing,
- *          prints the final board to the file along with the user's score and the number of true bombs remaining,
- *          and closes the file.
+/* Purpose: Returns how many bits of a mask are set.
  */
-void saveBoardToFile(char board[][NCOLS + 4], int score, int trueBombsRemaining) {
-	char fileName[FILENAME_MAX_LENGTH] = { 0 };
-	int row = 0;
+int countBits(uint64_t bits) {
+	int count = 0;
 
-	printf("Please enter a name for your file no longer than %d characters: ", FILENAME_MAX_LENGTH - 1);
-	scanf("%19s", fileName);
+	for (; bits != 0; bits &= bits - 1) {
+		count++;
+	}
+	return count;
+}
 
-	FILE* saveFile;
-	saveFile = fopen(fileName, "w");
-	if (saveFile == NULL) {
-		printf("Error: Could not open file for saving. Giving up on saving your file...\n\n");
+/* Purpose: Queues a tile that changed, and its neighbours, for solveLogically() to examine,
+ *          skipping any already queued or with nothing left to tell (covered, flagged, or zero tiles).
+ */
+void queueAround(Board* board, int index) {
+	int atRow = 0, atCol = 0, at = 0;
+
+	for (atRow = -1; atRow < 2; atRow++) {
+		for (atCol = -1; atCol < 2; atCol++) {
+			at = index + atRow * board->stride + atCol;
+			if ((board->tiles[at] & (REVEALED_BIT | FLAGGED_BIT | QUEUED_BIT)) == REVEALED_BIT &&
+				(board->tiles[at] & HINT_MASK) && pushInt(&board->work, at)) {
+				board->tiles[at] |= QUEUED_BIT;
+			}
+		}
 	}
-	else {
-		for (row = 0; row < NROWS + 2; row++) {
-			fprintf(saveFile, "%s", board[row]);
+}
+
+#define WINDOW_WIDTH 7
+#define WINDOW_BIT(dRow, dCol) ((uint64_t)1 << (((dRow) + 3) * WINDOW_WIDTH + (dCol) + 3))
+/* Purpose: Finds the covered, unflagged neighbours of a number tile, as bits of a 7x7 window whose centre
+ *          is (dRow, dCol) away from the tile, and how many of its bombs flags have yet to account for.
+ * Return:  The window bits of the covered neighbours, with the bombs left stored in *mines.
+ */
+uint64_t coveredAround(const Board* board, int row, int col, int dRow, int dCol, int* mines) {
+	const unsigned char* tile = &TILE(board, row - 1, col - 1);
+	uint64_t covered = 0;
+	int atRow = 0, atCol = 0;
+
+	/* Below: Branch-free, since whether a neighbour is covered is hard to predict. */
+	*mines = TILE(board, row, col) & HINT_MASK;
+	for (atRow = -1; atRow < 2; atRow++, tile += board->stride) {
+		for (atCol = -1; atCol < 2; atCol++) {
+			*mines -= (tile[atCol + 1] & FLAGGED_BIT) != 0;
+			covered |= (uint64_t)((tile[atCol + 1] & (REVEALED_BIT | FLAGGED_BIT)) == 0) * WINDOW_BIT(dRow + atRow, dCol + atCol);
 		}
-		fprintf(saveFile, "\nScore: %d seconds\nBombs remaining: %d", score, trueBombsRemaining);
-		fclose(saveFile);
+	}
+	return covered;
+}
+
+/* Purpose: Reveals the tiles of one window mask and flags those of another, for a window centred on (row, col).
+ */
+void settleTiles(Board* board, int row, int col, uint64_t safe, uint64_t mines) {
+	int bit = 0, atRow = 0, atCol = 0;
+
+	for (bit = 0; bit < WINDOW_WIDTH * WINDOW_WIDTH; bit++) {
+		atRow = row + bit / WINDOW_WIDTH - 3;
+		atCol = col + bit % WINDOW_WIDTH - 3;
+		if ((safe >> bit & 1) && !(TILE(board, atRow, atCol) & REVEALED_BIT)) {
+			sweepTile(board, atRow, atCol);
+		}
+		else if ((mines >> bit & 1) && !(TILE(board, atRow, atCol) & FLAGGED_BIT)) {
+			toggleFlag(board, atRow, atCol);
+		}
+	}
+}
+
+/* Purpose: Looks for something a revealed number tile proves about its covered neighbours, and acts on the first find.
+ *          The tile's own hint settles everything once it is met by flags or needs every covered neighbour.
+ *          If pairs is TRUE, it is also compared with each number tile sharing a covered neighbour with it: if the other
+ *          needs as many more bombs beyond the shared tiles as this one needs in all, every bomb of this one is shared,
+ *          so its other neighbours are safe and the other's are bombs.
+ * Return:  TRUE if any tile was revealed or flagged, or FALSE otherwise.
+ */
+int examineTile(Board* board, int index, int pairs) {
+	int row = index / board->stride, col = index % board->stride;
+	int mines = 0, otherMines = 0, atRow = 0, atCol = 0, dRow = 0, dCol = 0;
+	uint64_t covered = coveredAround(board, row, col, 0, 0, &mines);
+	uint64_t other = 0, onlyHere = 0, onlyThere = 0, compared = WINDOW_BIT(0, 0);
+
+	if (covered == 0) {
+		return FALSE;
+	}
+	if (mines == 0) {
+		settleTiles(board, row, col, covered, 0);
+		return TRUE;
+	}
+	if (mines == countBits(covered)) {
+		settleTiles(board, row, col, 0, covered);
+		return TRUE;
+	}
+
+	/* Below: Every tile next to one of the covered neighbours, each once. They are never on the border,
+	 *        since border tiles have no hint. */
+	for (atRow = -1; pairs && atRow < 2; atRow++) {
+		for (atCol = -1; atCol < 2; atCol++) {
+			if (!(covered & WINDOW_BIT(atRow, atCol))) {
+				continue;
+			}
+			for (dRow = atRow - 1; dRow < atRow + 2; dRow++) {
+				for (dCol = atCol - 1; dCol < atCol + 2; dCol++) {
+					if ((compared & WINDOW_BIT(dRow, dCol)) ||
+						!(TILE(board, row + dRow, col + dCol) & REVEALED_BIT) || !(TILE(board, row + dRow, col + dCol) & HINT_MASK)) {
+						continue;
+					}
+					compared |= WINDOW_BIT(dRow, dCol);
+					other = coveredAround(board, row + dRow, col + dCol, dRow, dCol, &otherMines);
+					onlyHere = covered & ~other;
+					onlyThere = other & ~covered;
+					if ((onlyHere | onlyThere) == 0) {
+						continue;
+					}
+					if (otherMines - countBits(onlyThere) == mines) {
+						settleTiles(board, row, col, onlyHere, onlyThere);
+						return TRUE;
+					}
+					if (mines - countBits(onlyHere) == otherMines) {
+						settleTiles(board, row, col, onlyThere, onlyHere);
+						return TRUE;
+					}
+				}
+			}
+		}
+	}
+	return FALSE;
+}
+
+/* Purpose: Gets a board ready for deduceAll(), logging every change from here on.
+ */
+void startSolving(Board* board) {
+	board->logging = TRUE;
+	board->changes.count = 0;
+	board->work.count = 0;
+	board->stuck.count = 0;
+}
+
+/* Purpose: Acts on everything the revealed hints prove, through examineTile(), and clears whatever is left
+ *          once every bomb is flagged. Stops when the board is cleared or it would take a guess to go on.
+ * Param:   frontier - If not NULL, every number tile revealed along the way is added to it.
+ * Note:    Only ever reveals safe tiles and flags bombs. A tile is examined again only after one of its neighbours
+ *          changes, so the work grows with the tiles revealed rather than with the passes made over the board.
+ *          Tiles are only compared in pairs once no tile can make progress alone, since that is the costlier check.
+ */
+void deduceAll(Board* board, IntList* frontier) {
+	int at = 0, index = 0;
+
+	while (board->safeRemaining > 0) {
+		for (at = 0; at < board->changes.count; at++) {
+			index = board->changes.items[at];
+			if (frontier != NULL && (board->tiles[index] & REVEALED_BIT) && (board->tiles[index] & HINT_MASK)) {
+				pushInt(frontier, index);
+			}
+			queueAround(board, index);
+		}
+		board->changes.count = 0;
+
+		if (board->work.count > 0) {
+			index = board->work.items[--board->work.count];
+			board->tiles[index] &= ~QUEUED_BIT;
+			if (!examineTile(board, index, FALSE)) {
+				pushInt(&board->stuck, index);
+			}
+		}
+		else if (board->stuck.count > 0) {
+			index = board->stuck.items[--board->stuck.count];
+			examineTile(board, index, TRUE);
+		}
+		else if (board->flags == board->bombs) {
+			for (index = board->stride; index < (board->rows + 1) * board->stride; index++) {
+				if (!(board->tiles[index] & (REVEALED_BIT | FLAGGED_BIT))) {
+					sweepTile(board, index / board->stride, index % board->stride);
+				}
+			}
+		}
+		else {
+			break;
+		}
+	}
+}
+
+/* Purpose: Undoes startSolving(), clearing the marks of anything left queued.
+ */
+void stopSolving(Board* board) {
+	while (board->work.count > 0) {
+		board->tiles[board->work.items[--board->work.count]] &= ~QUEUED_BIT;
+	}
+	board->stuck.count = 0;
+	board->logging = FALSE;
+	board->changes.count = 0;
+}
+
+/* Purpose: Plays from (row, col) using only what the revealed hints prove, through deduceAll().
+ * Return:  TRUE if every safe tile ended up revealed, or FALSE if it would take a guess to go on.
+ */
+int solveLogically(Board* board, int row, int col) {
+	startSolving(board);
+	revealTile(board, row * board->stride + col);
+	deduceAll(board, NULL);
+	stopSolving(board);
+	return board->safeRemaining == 0;
+}
+
+/* Purpose: Returns the number of processors available to run threads on.
+ */
+int countCores(void) {
+#ifdef _WIN32
+	SYSTEM_INFO info;
+
+	GetSystemInfo(&info);
+	return (int)info.dwNumberOfProcessors;
+#else
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	return cores > 0 ? (int)cores : 1;
+#endif
+}
+
+/* Purpose: Returns TRUE once the clock has reached the given time.
+ */
+int isPast(const struct timespec* when) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+	return now.tv_sec > when->tv_sec || (now.tv_sec == when->tv_sec && now.tv_nsec >= when->tv_nsec);
+}
+
+/* Purpose: Deals and tries candidate layouts for newNoGuessAnswer() until none below the best success so far are left,
+ *          or the job's deadline passes.
+ * Note:    The deadline is checked before taking a candidate, so every candidate handed out is tried. Since they are
+ *          handed out in order, all those below a success have been tried by the time every thread returns.
+ * Return:  Zero, as thrd_start_t functions must.
+ */
+int noGuessWorker(void* worker) {
+	NoGuessJob* job = ((NoGuessWorker*)worker)->job;
+	Board* board = ((NoGuessWorker*)worker)->board;
+	int candidate = 0, best = 0;
+
+	while (!isPast(&job->deadline) && (candidate = atomic_fetch_add(&job->next, 1)) < atomic_load(&job->found)) {
+		resetBoard(board);
+		board->random = streamSeed(job->seed, (uint64_t)candidate);
+		newAnswer(board, job->move);
+		prepareHints(board);
+		if (solveLogically(board, job->move[MROW], job->move[MCOL])) {
+			best = atomic_load(&job->found);
+			while (candidate < best && !atomic_compare_exchange_weak(&job->found, &best, candidate)) {
+			}
+		}
+	}
+	return 0;
+}
+
+#define MAX_THREADS 64
+#define NOGUESS_MILLISECONDS 300
+/* Purpose: Generates a distribution of bombs like newAnswer() that solveLogically() can clear from the player's
+ *          starting coordinate, trying candidate layouts on up to the given number of threads for a limited time.
+ * Note:    The layout dealt is the lowest-numbered candidate that works, so once one is found it depends only on
+ *          board->random and not on the number of threads or how they were scheduled. Whether one is found in time
+ *          on a dense board can still depend on how fast the candidates go.
+ * Return:  How many candidates it took, or zero if none worked in time and a plain layout was dealt instead.
+ */
+int newNoGuessAnswer(Board* board, int move[], int threads) {
+	NoGuessJob job;
+	NoGuessWorker workers[MAX_THREADS];
+	thrd_t handles[MAX_THREADS];
+	FILE* journal = board->journal;
+	uint64_t random = 0;
+	int started = 0, at = 0, found = 0;
+
+	job.move = move;
+	job.seed = nextRandom(&board->random);
+	atomic_init(&job.next, 0);
+	atomic_init(&job.found, INT_MAX);
+	timespec_get(&job.deadline, TIME_UTC);
+	job.deadline.tv_sec += NOGUESS_MILLISECONDS / 1000;
+	job.deadline.tv_nsec += NOGUESS_MILLISECONDS % 1000 * 1000000L;
+	if (job.deadline.tv_nsec >= 1000000000L) {
+		job.deadline.tv_sec++;
+		job.deadline.tv_nsec -= 1000000000L;
+	}
+	threads = threads < 1 ? 1 : threads > MAX_THREADS ? MAX_THREADS : threads;
+
+	/* Below: This thread works on the board itself, and the others get boards of their own.
+	 * The trial moves on it are not the player's, so they are kept out of its journal. */
+	board->journal = NULL;
+	workers[0].job = &job;
+	workers[0].board = board;
+	for (started = 1; started < threads; started++) {
+		workers[started].job = &job;
+		workers[started].board = newBoard(board->rows, board->cols, board->bombs);
+		if (workers[started].board == NULL) {
+			break;
+		}
+		if (thrd_create(&handles[started], noGuessWorker, &workers[started]) != thrd_success) {
+			freeBoard(workers[started].board);
+			break;
+		}
+	}
+	noGuessWorker(&workers[0]);
+	for (at = 1; at < started; at++) {
+		thrd_join(handles[at], NULL);
+		freeBoard(workers[at].board);
+	}
+	board->journal = journal;
+
+	/* Below: Deals the chosen layout again, unsolved, without disturbing the board's own stream. */
+	found = atomic_load(&job.found);
+	random = board->random;
+	resetBoard(board);
+	board->random = streamSeed(job.seed, (uint64_t)found);
+	newAnswer(board, move);
+	board->random = random;
+	return found < INT_MAX ? found + 1 : 0;
+}
+
+#define BENCH_BOARDS 200
+/* Purpose: Times newNoGuessAnswer() on every core for random starting coordinates and prints the results.
+ * Return:  Zero, or one if the board could not be made.
+ */
+int benchmarkNoGuess(int rows, int cols, int bombs) {
+	Board* board = newBoard(rows, cols, bombs);
+	int move[MOVE_LENGTH] = { 0 };
+	int round = 0, tried = 0, cleared = 0, candidates = 0;
+	double seconds = 0, total = 0, slowest = 0;
+	struct timespec start, end;
+
+	if (board == NULL) {
+		return 1;
+	}
+	board->random = (uint64_t)time(NULL);
+	for (round = 0; round < BENCH_BOARDS; round++) {
+		move[MROW] = randomCoordinate(&board->random, rows) + 1;
+		move[MCOL] = randomCoordinate(&board->random, cols) + 1;
+		timespec_get(&start, TIME_UTC);
+		tried = newNoGuessAnswer(board, move, countCores());
+		timespec_get(&end, TIME_UTC);
+		seconds = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+		total += seconds;
+		slowest = seconds > slowest ? seconds : slowest;
+		candidates += tried;
+		cleared += tried > 0;
+	}
+
+	printf("%d no-guess deal(s) of %dx%d with %d bombs on %d thread(s):\n", round, rows, cols, bombs, countCores());
+	printf("  found:      %d of %d\n", cleared, round);
+	printf("  candidates: %.1f per deal\n", cleared ? (double)candidates / cleared : 0.0);
+	printf("  average:    %.3f ms\n", 1e3 * total / round);
+	printf("  slowest:    %.3f ms\n", 1e3 * slowest);
+	freeBoard(board);
+	return 0;
+}
+
+/* Purpose: Allocates empty scratch space for playBot().
+ * Return:  The new bot, or NULL if there is no memory for it.
+ */
+Bot* newBot(void) {
+	return calloc(1, sizeof(Bot));
+}
+
+/* Purpose: Releases a bot from newBot().
+ */
+void freeBot(Bot* bot) {
+	IntList* lists[] = { &bot->frontier, &bot->cells, &bot->link, &bot->slot, &bot->group, &bot->byGroup,
+		&bot->groupStart, &bot->order, &bot->orderStart, &bot->entryOf, &bot->cellRules, &bot->ruleCount,
+		&bot->need, &bot->open, &bot->left, &bot->shift, &bot->layerStart, &bot->stepStart };
+	int at = 0;
+
+	if (bot != NULL) {
+		for (at = 0; at < (int)(sizeof(lists) / sizeof(lists[0])); at++) {
+			free(lists[at]->items);
+		}
+		free(bot->entries);
+		free(bot->steps);
+		free(bot->keys);
+		free(bot->tallies);
+		free(bot->pool);
+		free(bot->product);
+		free(bot);
+	}
+}
+
+/* Purpose: Sets how many items a list holds, growing it as needed. New items are left unset.
+ * Return:  TRUE on success, or FALSE if there is no memory left for them.
+ */
+int sizeInts(IntList* list, int count) {
+	int length = list->length < MIN_PENDING ? MIN_PENDING : list->length;
+	int* grown = NULL;
+
+	if (count > list->length) {
+		while (length < count) {
+			length *= 2;
+		}
+		grown = realloc(list->items, (size_t)length * sizeof(int));
+		if (grown == NULL) {
+			return FALSE;
+		}
+		list->items = grown;
+		list->length = length;
+	}
+	list->count = count;
+	return TRUE;
+}
+
+/* Purpose: Makes sure an array has room for at least needed items of the given size, growing it as needed.
+ * Return:  The array, which may have moved, or NULL if there is no memory left for it. The old one is then kept.
+ */
+void* growArray(void* array, size_t* length, size_t needed, size_t size) {
+	size_t grownLength = *length < MIN_PENDING ? MIN_PENDING : *length;
+	void* grown = NULL;
+
+	if (needed <= *length) {
+		return array;
+	}
+	while (grownLength < needed) {
+		grownLength *= 2;
+	}
+	grown = realloc(array, grownLength * size);
+	if (grown != NULL) {
+		*length = grownLength;
+	}
+	return grown;
+}
+
+/* Purpose: Orders ints from lowest to highest for qsort() and bsearch().
+ */
+int compareInts(const void* first, const void* second) {
+	return (*(const int*)first > *(const int*)second) - (*(const int*)first < *(const int*)second);
+}
+
+/* Purpose: Returns the cell number of a covered frontier tile, or -1 if it is not one.
+ */
+int findCell(const Bot* bot, int index) {
+	const int* found = bsearch(&index, bot->cells.items, (size_t)bot->cells.count, sizeof(int), compareInts);
+
+	return found == NULL ? -1 : (int)(found - bot->cells.items);
+}
+
+/* Purpose: Returns the union-find root of a cell, shortening the path to it on the way.
+ */
+int findRoot(Bot* bot, int cell) {
+	int* link = bot->link.items;
+
+	while (link[cell] != cell) {
+		link[cell] = link[link[cell]];
+		cell = link[cell];
+	}
+	return cell;
+}
+
+/* Purpose: Splits the frontier into components that share no covered tiles, so each can be counted on its own.
+ *          Fills bot->cells, and the rules and cells of each component into byGroup and order.
+ * Note:    The frontier list is only trimmed of tiles with nothing left covered, never rebuilt, so the cost
+ *          follows the size of the frontier rather than the board.
+ * Return:  The number of components, or -1 if there was no memory for them.
+ */
+int groupFrontier(Board* board, Bot* bot) {
+	unsigned char* tiles = board->tiles;
+	const int offsets[8] = { -board->stride - 1, -board->stride, -board->stride + 1, -1,
+		1, board->stride - 1, board->stride, board->stride + 1 };
+	int at = 0, direction = 0, index = 0, cell = 0, first = 0, kept = 0, groups = 0, mines = 0;
+
+	/* Below: Drops rules with nothing left covered, and lists the covered tiles of the rest once each. */
+	bot->cells.count = 0;
+	for (at = 0; at < bot->frontier.count; at++) {
+		index = bot->frontier.items[at];
+		if (coveredAround(board, index / board->stride, index % board->stride, 0, 0, &mines) == 0) {
+			continue;
+		}
+		bot->frontier.items[kept++] = index;
+		for (direction = 0; direction < 8; direction++) {
+			if (!(tiles[index + offsets[direction]] & (REVEALED_BIT | FLAGGED_BIT | QUEUED_BIT)) &&
+				pushInt(&bot->cells, index + offsets[direction])) {
+				tiles[index + offsets[direction]] |= QUEUED_BIT;
+			}
+		}
+	}
+	bot->frontier.count = kept;
+	for (at = 0; at < bot->cells.count; at++) {
+		tiles[bot->cells.items[at]] &= ~QUEUED_BIT;
+	}
+	qsort(bot->frontier.items, (size_t)kept, sizeof(int), compareInts);
+	qsort(bot->cells.items, (size_t)bot->cells.count, sizeof(int), compareInts);
+
+	if (!sizeInts(&bot->link, bot->cells.count) || !sizeInts(&bot->slot, bot->cells.count) ||
+		!sizeInts(&bot->group, kept) || !sizeInts(&bot->byGroup, kept) || !sizeInts(&bot->groupStart, kept + 2) ||
+		!sizeInts(&bot->order, bot->cells.count) || !sizeInts(&bot->orderStart, kept + 2)) {
+		return -1;
+	}
+
+	/* Below: Joins the cells of each rule. */
+	for (cell = 0; cell < bot->cells.count; cell++) {
+		bot->link.items[cell] = cell;
+		bot->slot.items[cell] = -1;
+	}
+	for (at = 0; at < kept; at++) {
+		first = -1;
+		for (direction = 0; direction < 8; direction++) {
+			index = bot->frontier.items[at] + offsets[direction];
+			if (!(tiles[index] & (REVEALED_BIT | FLAGGED_BIT))) {
+				cell = findRoot(bot, findCell(bot, index));
+				if (first < 0) {
+					first = cell;
+				}
+				else if (cell != first) {
+					bot->link.items[cell] = first;
+				}
+			}
+		}
+	}
+
+	/* Below: Numbers the components and sorts the rules by them, keeping them in tile order within each. */
+	for (at = 0; at < kept; at++) {
+		for (direction = 0; tiles[bot->frontier.items[at] + offsets[direction]] & (REVEALED_BIT | FLAGGED_BIT); direction++) {
+		}
+		cell = findRoot(bot, findCell(bot, bot->frontier.items[at] + offsets[direction]));
+		if (bot->slot.items[cell] < 0) {
+			bot->slot.items[cell] = groups++;
+		}
+		bot->group.items[at] = bot->slot.items[cell];
+	}
+	memset(bot->groupStart.items, 0, (size_t)(groups + 1) * sizeof(int));
+	for (at = 0; at < kept; at++) {
+		bot->groupStart.items[bot->group.items[at] + 1]++;
+	}
+	for (at = 0; at < groups; at++) {
+		bot->groupStart.items[at + 1] += bot->groupStart.items[at];
+	}
+	for (at = 0; at < kept; at++) {
+		bot->byGroup.items[bot->groupStart.items[bot->group.items[at]]++] = bot->frontier.items[at];
+	}
+	for (at = groups; at > 0; at--) {
+		bot->groupStart.items[at] = bot->groupStart.items[at - 1];
+	}
+	bot->groupStart.items[0] = 0;
+
+	/* Below: Lists each component's cells in the order its rules reach them, which keeps few rules open at once
+	 *        while counting. link now holds each cell's place within its component. */
+	for (cell = 0; cell < bot->cells.count; cell++) {
+		bot->link.items[cell] = -1;
+	}
+	kept = 0;
+	for (first = 0; first < groups; first++) {
+		bot->orderStart.items[first] = kept;
+		for (at = bot->groupStart.items[first]; at < bot->groupStart.items[first + 1]; at++) {
+			for (direction = 0; direction < 8; direction++) {
+				index = bot->byGroup.items[at] + offsets[direction];
+				if (!(tiles[index] & (REVEALED_BIT | FLAGGED_BIT)) && bot->link.items[cell = findCell(bot, index)] < 0) {
+					bot->link.items[cell] = kept - bot->orderStart.items[first];
+					bot->order.items[kept++] = index;
+				}
+			}
+		}
+	}
+	bot->orderStart.items[groups] = kept;
+	return groups;
+}
+
+#define MAX_SLOTS 16 /* Rules open at once that a key has room for. */
+#define STEP_LIMIT 200000 /* Most steps to take counting one component before settling for estimates. */
+/* Purpose: Orders steps by the key they lead to, for qsort().
+ */
+int compareSteps(const void* first, const void* second) {
+	const uint64_t firstKey = ((const BotStep*)first)->key, secondKey = ((const BotStep*)second)->key;
+
+	return (firstKey > secondKey) - (firstKey < secondKey);
+}
+
+/* Purpose: Counts every arrangement of bombs on a component's cells that meets all of its rules, by how many bombs
+ *          it holds, from the lists of rules and cells countComponent() fills.
+ * Param:   counts - Zeroed space for counts[k], the arrangements with k bombs, followed for each cell i by
+ *                   counts[(i + 1) * (size + 1) + k], those of them with a bomb on cell i.
+ * Note:    Rather than trying arrangements one by one, passes over the cells in order through layers of states:
+ *          how many bombs each rule still open has been given so far. Arrangements reaching the same state are
+ *          counted together, so a long frontier costs about its length rather than its number of arrangements.
+ * Return:  TRUE, or FALSE if it had too many rules open at once or steps to take, or no memory left for them.
+ */
+int countArrangements(Bot* bot, int size, int rules, double* counts) {
+	const int width = size + 1;
+	const int* cellRules = NULL;
+	unsigned freeSlots = (1u << MAX_SLOTS) - 1;
+	uint64_t key = 0;
+	BotStep* step = NULL;
+	void* grown = NULL;
+	int at = 0, state = 0, states = 1, value = 0, rule = 0, fits = FALSE, placed = 0, low = 0, high = 0;
+	double* forward = NULL;
+	double* backward = NULL;
+	double tally = 0;
+
+	if (!sizeInts(&bot->left, rules) || !sizeInts(&bot->shift, rules) ||
+		!sizeInts(&bot->layerStart, size + 2) || !sizeInts(&bot->stepStart, size + 1) ||
+		(grown = growArray(bot->keys, &bot->keyLength, 1, sizeof(uint64_t))) == NULL) {
+		return FALSE;
+	}
+	bot->keys = grown;
+	for (rule = 0; rule < rules; rule++) {
+		bot->left.items[rule] = bot->open.items[rule];
+		bot->shift.items[rule] = -1;
+	}
+	bot->keys[0] = 0;
+	bot->layerStart.items[0] = 0;
+	bot->layerStart.items[1] = 1;
+	bot->stepCount = 0;
+
+	for (at = 0; at < size; at++) {
+		cellRules = &bot->cellRules.items[8 * at];
+		for (rule = 0; rule < bot->ruleCount.items[at]; rule++) {
+			if (bot->shift.items[cellRules[rule]] < 0) {
+				if (freeSlots == 0) {
+					return FALSE;
+				}
+				bot->shift.items[cellRules[rule]] = 4 * countBits((freeSlots & -freeSlots) - 1);
+				freeSlots &= freeSlots - 1;
+			}
+			bot->left.items[cellRules[rule]]--;
+		}
+
+		/* Below: Steps from every state across this cell, closing the rules it is the last cell of. */
+		bot->stepStart.items[at] = (int)bot->stepCount;
+		for (state = bot->layerStart.items[at]; state < bot->layerStart.items[at + 1]; state++) {
+			for (value = 0; value < 2; value++) {
+				key = bot->keys[state];
+				fits = TRUE;
+				for (rule = 0; rule < bot->ruleCount.items[at]; rule++) {
+					placed = (int)(key >> bot->shift.items[cellRules[rule]] & 0xF) + value;
+					fits = fits && placed <= bot->need.items[cellRules[rule]] &&
+						placed + bot->left.items[cellRules[rule]] >= bot->need.items[cellRules[rule]];
+					key &= ~((uint64_t)0xF << bot->shift.items[cellRules[rule]]);
+					key |= (uint64_t)(bot->left.items[cellRules[rule]] ? placed : 0) << bot->shift.items[cellRules[rule]];
+				}
+				if (!fits) {
+					continue;
+				}
+				if (bot->stepCount == STEP_LIMIT ||
+					(grown = growArray(bot->steps, &bot->stepLength, bot->stepCount + 1, sizeof(BotStep))) == NULL) {
+					return FALSE;
+				}
+				bot->steps = grown;
+				step = &bot->steps[bot->stepCount++];
+				step->key = key;
+				step->from = state;
+				step->value = value;
+			}
+		}
+		for (rule = 0; rule < bot->ruleCount.items[at]; rule++) {
+			if (bot->left.items[cellRules[rule]] == 0) {
+				freeSlots |= 1u << bot->shift.items[cellRules[rule]] / 4;
+			}
+		}
+
+		/* Below: Steps reaching the same key reach the same state after the cell. */
+		qsort(&bot->steps[bot->stepStart.items[at]], bot->stepCount - bot->stepStart.items[at], sizeof(BotStep), compareSteps);
+		for (step = &bot->steps[bot->stepStart.items[at]]; step < bot->steps + bot->stepCount; step++) {
+			if (states == bot->layerStart.items[at + 1] || step->key != bot->keys[states - 1]) {
+				if ((grown = growArray(bot->keys, &bot->keyLength, (size_t)states + 1, sizeof(uint64_t))) == NULL) {
+					return FALSE;
+				}
+				bot->keys = grown;
+				bot->keys[states++] = step->key;
+			}
+			step->to = states - 1;
+		}
+		bot->layerStart.items[at + 2] = states;
+	}
+	bot->stepStart.items[size] = (int)bot->stepCount;
+
+	/* Below: Tallies the arrangements reaching each state by bombs so far, then those finishing from it by bombs to come. */
+	if ((grown = growArray(bot->tallies, &bot->tallyLength, 2 * (size_t)states * width, sizeof(double))) == NULL) {
+		return FALSE;
+	}
+	bot->tallies = grown;
+	forward = bot->tallies;
+	backward = forward + (size_t)states * width;
+	memset(forward, 0, 2 * (size_t)states * width * sizeof(double));
+	forward[0] = 1;
+	for (at = 0; at < size; at++) {
+		for (step = &bot->steps[bot->stepStart.items[at]]; step < &bot->steps[bot->stepStart.items[at + 1]]; step++) {
+			for (low = 0; low <= at; low++) {
+				forward[(size_t)step->to * width + low + step->value] += forward[(size_t)step->from * width + low];
+			}
+		}
+	}
+	for (state = bot->layerStart.items[size]; state < states; state++) {
+		backward[(size_t)state * width] = 1;
+		for (low = 0; low < width; low++) {
+			counts[low] += forward[(size_t)state * width + low];
+		}
+	}
+	for (at = size - 1; at >= 0; at--) {
+		for (step = &bot->steps[bot->stepStart.items[at]]; step < &bot->steps[bot->stepStart.items[at + 1]]; step++) {
+			for (high = 0; high < size - at; high++) {
+				backward[(size_t)step->from * width + high + step->value] += backward[(size_t)step->to * width + high];
+			}
+		}
+	}
+
+	/* Below: Every step putting a bomb on a cell joins each way of reaching it to each way of finishing after it. */
+	for (at = 0; at < size; at++) {
+		for (step = &bot->steps[bot->stepStart.items[at]]; step < &bot->steps[bot->stepStart.items[at + 1]]; step++) {
+			for (low = 0; step->value && low <= at; low++) {
+				tally = forward[(size_t)step->from * width + low];
+				for (high = 0; tally != 0 && high < size - at; high++) {
+					counts[(size_t)(at + 1) * width + low + 1 + high] += tally * backward[(size_t)step->to * width + high];
+				}
+			}
+		}
+	}
+	return TRUE;
+}
+
+#define MAX_COUNTED 400 /* Largest component counted exactly. */
+/* Purpose: Finds a component's arrangement counts in the cache, or counts them and caches them.
+ *          A component is only recounted once the hints around it change, so a reveal elsewhere costs nothing here.
+ *          Components too large or tangled to count get estimates instead: for each cell, the highest share of
+ *          bombs any of its rules needs among their covered tiles.
+ * Return:  The component's cache entry, or -1 if there was no memory for it.
+ */
+int countComponent(Board* board, Bot* bot, int component) {
+	const int start = bot->orderStart.items[component];
+	const int size = bot->orderStart.items[component + 1] - start;
+	const int firstRule = bot->groupStart.items[component];
+	const int rules = bot->groupStart.items[component + 1] - firstRule;
+	uint64_t signature = 0xCBF29CE484222325ULL, covered = 0;
+	BotEntry* entry = NULL;
+	void* grown = NULL;
+	size_t needed = 0;
+	int at = 0, rule = 0, mines = 0, index = 0, cell = 0, direction = 0;
+	double share = 0;
+
+	for (rule = 0; rule < rules; rule++) {
+		index = bot->byGroup.items[firstRule + rule];
+		covered = coveredAround(board, index / board->stride, index % board->stride, 0, 0, &mines);
+		signature = (signature ^ (uint64_t)index) * 0x100000001B3ULL;
+		signature = (signature ^ (covered << 4 | (uint64_t)mines)) * 0x100000001B3ULL;
+	}
+	for (at = 0; at < bot->entryCount; at++) {
+		if (bot->entries[at].signature == signature && bot->entries[at].size == size) {
+			return at;
+		}
+	}
+
+	/* Below: Lists the rules of every cell, and what each rule needs. */
+	if (!sizeInts(&bot->cellRules, 8 * size) || !sizeInts(&bot->ruleCount, size) ||
+		!sizeInts(&bot->need, rules) || !sizeInts(&bot->open, rules)) {
+		return -1;
+	}
+	memset(bot->ruleCount.items, 0, (size_t)size * sizeof(int));
+	for (rule = 0; rule < rules; rule++) {
+		index = bot->byGroup.items[firstRule + rule];
+		coveredAround(board, index / board->stride, index % board->stride, 0, 0, &bot->need.items[rule]);
+		bot->open.items[rule] = 0;
+		for (direction = 0; direction < 9; direction++) {
+			at = index + (direction / 3 - 1) * board->stride + direction % 3 - 1;
+			if (direction != 4 && !(board->tiles[at] & (REVEALED_BIT | FLAGGED_BIT))) {
+				cell = bot->link.items[findCell(bot, at)];
+				bot->cellRules.items[8 * cell + bot->ruleCount.items[cell]++] = rule;
+				bot->open.items[rule]++;
+			}
+		}
+	}
+
+	if ((grown = growArray(bot->entries, &bot->entryLength, bot->entryCount + 1, sizeof(BotEntry))) == NULL) {
+		return -1;
+	}
+	bot->entries = grown;
+	entry = &bot->entries[bot->entryCount];
+	entry->signature = signature;
+	entry->size = size;
+	entry->offset = bot->poolCount;
+	entry->exact = size <= MAX_COUNTED;
+	needed = entry->exact ? (size_t)(size + 1) * (size + 1) : (size_t)size;
+	if ((grown = growArray(bot->pool, &bot->poolLength, bot->poolCount + needed, sizeof(double))) == NULL) {
+		return -1;
+	}
+	bot->pool = grown;
+	memset(&bot->pool[entry->offset], 0, needed * sizeof(double));
+
+	if (entry->exact && !countArrangements(bot, size, rules, &bot->pool[entry->offset])) {
+		entry->exact = FALSE;
+		memset(&bot->pool[entry->offset], 0, (size_t)size * sizeof(double));
+	}
+	if (!entry->exact) {
+		for (cell = 0; cell < size; cell++) {
+			for (rule = 0; rule < bot->ruleCount.items[cell]; rule++) {
+				share = (double)bot->need.items[bot->cellRules.items[8 * cell + rule]] / bot->open.items[bot->cellRules.items[8 * cell + rule]];
+				if (share > bot->pool[entry->offset + cell]) {
+					bot->pool[entry->offset + cell] = share;
+				}
+			}
+		}
+		needed = (size_t)size;
+	}
+	bot->poolCount += needed;
+	return bot->entryCount++;
+}
+
+/* Purpose: Multiplies the polynomial in result by factor, scaling factor so its largest coefficient is one.
+ * Return:  The length of the product.
+ */
+int multiplyInto(Bot* bot, double* result, int length, const double* factor, int factorLength) {
+	double largest = 0;
+	int at = 0, term = 0;
+
+	for (term = 0; term < factorLength; term++) {
+		largest = factor[term] > largest ? factor[term] : largest;
+	}
+	for (at = 0; at < length + factorLength - 1; at++) {
+		bot->spread[at] = 0;
+	}
+	for (at = 0; at < length; at++) {
+		for (term = 0; term < factorLength; term++) {
+			bot->spread[at + term] += result[at] * factor[term] / largest;
+		}
+	}
+	memcpy(result, bot->spread, (size_t)(length + factorLength - 1) * sizeof(double));
+	return length + factorLength - 1;
+}
+
+#define CORNERS 4
+/* Purpose: Picks a covered tile away from the frontier to guess on, preferring corners, which are likeliest to open up.
+ * Return:  Its position in board->tiles, or -1 if there is none.
+ */
+int pickInterior(Board* board, const Bot* bot) {
+	const int corners[CORNERS] = { board->stride + 1, board->stride + board->cols,
+		board->rows * board->stride + 1, board->rows * board->stride + board->cols };
+	int at = 0, index = 0;
+
+	for (at = 0; at < CORNERS; at++) {
+		if (!(board->tiles[corners[at]] & (REVEALED_BIT | FLAGGED_BIT)) && findCell(bot, corners[at]) < 0) {
+			return corners[at];
+		}
+	}
+	for (index = board->stride; index < (board->rows + 1) * board->stride; index++) {
+		if (!(board->tiles[index] & (REVEALED_BIT | FLAGGED_BIT)) && findCell(bot, index) < 0) {
+			return index;
+		}
+	}
+	return -1;
+}
+
+/* Purpose: Works out the chance of a bomb under every covered tile once deduceAll() is stuck, by counting the
+ *          arrangements of each frontier component (countComponent()) and weighing every way of splitting the
+ *          bombs left between them and the tiles away from the frontier. Sweeps every tile that proves safe and
+ *          flags every one that proves a bomb; if none do, sweeps the tile least likely to be a bomb.
+ * Note:    Tiles of components only estimated are treated as away from the frontier when splitting the bombs.
+ * Return:  LOSE if the guess was a bomb or there was no memory to go on, or TRUE otherwise.
+ */
+int probeFrontier(Board* board, Bot* bot) {
+	const int left = board->bombs - board->flags;
+	int groups = groupFrontier(board, bot);
+	int away = 0, length = 1, otherLength = 0, component = 0, other = 0, at = 0, term = 0, cell = 0, index = 0;
+	int size = 0, best = -1, acted = FALSE, safe = FALSE, bomb = FALSE;
+	double total = 0, chance = 0, bestChance = 2, largest = -HUGE_VAL, arrangements = 0;
+	const double* counts = NULL;
+	const BotEntry* entry = NULL;
+	void* grown = NULL;
+
+	if (groups < 0 || !sizeInts(&bot->entryOf, groups) ||
+		(grown = growArray(bot->product, &bot->polyLength, 4 * ((size_t)bot->cells.count + 1), sizeof(double))) == NULL) {
+		return LOSE;
+	}
+	bot->product = grown;
+	bot->others = bot->product + bot->cells.count + 1;
+	bot->spread = bot->others + bot->cells.count + 1;
+	bot->weight = bot->spread + bot->cells.count + 1;
+
+	/* Below: Multiplies together the arrangement counts of the exactly counted components, so product[k] weighs
+	 *        the ways they can hold k bombs between them. */
+	bot->product[0] = 1;
+	for (component = 0; component < groups; component++) {
+		bot->entryOf.items[component] = countComponent(board, bot, component);
+		if (bot->entryOf.items[component] < 0) {
+			return LOSE;
+		}
+		entry = &bot->entries[bot->entryOf.items[component]];
+		if (entry->exact) {
+			length = multiplyInto(bot, bot->product, length, &bot->pool[entry->offset], entry->size + 1);
+		}
+	}
+
+	/* Below: weight[k] is proportional to the ways the tiles away from the frontier can hold the other left - k bombs. */
+	away = board->safeRemaining + left - (length - 1);
+	for (at = 0; at < length; at++) {
+		bot->weight[at] = left - at >= 0 && left - at <= away ?
+			lgamma(away + 1.0) - lgamma(left - at + 1.0) - lgamma(away - left + at + 1.0) : -HUGE_VAL;
+		largest = bot->weight[at] > largest ? bot->weight[at] : largest;
+	}
+	for (at = 0; at < length; at++) {
+		bot->weight[at] = bot->weight[at] == -HUGE_VAL ? 0 : exp(bot->weight[at] - largest);
+		total += bot->product[at] * bot->weight[at];
+	}
+	index = pickInterior(board, bot);
+	if (index >= 0 && total > 0) {
+		for (at = 0; at < length; at++) {
+			chance += bot->product[at] * bot->weight[at] * (left - at);
+		}
+		bestChance = chance / away / total;
+		best = index;
+	}
+
+	for (component = 0; component < groups; component++) {
+		entry = &bot->entries[bot->entryOf.items[component]];
+		size = entry->size;
+		counts = &bot->pool[entry->offset];
+		if (!entry->exact) {
+			for (cell = 0; cell < size; cell++) {
+				if (counts[cell] < bestChance) {
+					bestChance = counts[cell];
+					best = bot->order.items[bot->orderStart.items[component] + cell];
+				}
+			}
+			continue;
+		}
+
+		/* Below: others weighs the ways every other counted component can hold its bombs, and spread[k] how
+		 *        likely everything else is to leave this one k bombs. */
+		bot->others[0] = 1;
+		otherLength = 1;
+		for (other = 0; other < groups; other++) {
+			entry = &bot->entries[bot->entryOf.items[other]];
+			if (other != component && entry->exact) {
+				otherLength = multiplyInto(bot, bot->others, otherLength, &bot->pool[entry->offset], entry->size + 1);
+			}
+		}
+		arrangements = 0;
+		for (at = 0; at <= size; at++) {
+			bot->spread[at] = 0;
+			for (term = 0; term < otherLength && at + term < length; term++) {
+				bot->spread[at] += bot->others[term] * bot->weight[at + term];
+			}
+			arrangements += counts[at] * bot->spread[at];
+		}
+		if (arrangements <= 0) {
+			continue;
+		}
+
+		for (cell = 0; cell < size; cell++) {
+			chance = 0;
+			safe = bomb = TRUE;
+			for (at = 0; at <= size; at++) {
+				if (bot->spread[at] > 0 && counts[at] > 0) {
+					chance += counts[(cell + 1) * (size + 1) + at] * bot->spread[at];
+					safe = safe && counts[(cell + 1) * (size + 1) + at] == 0;
+					bomb = bomb && counts[(cell + 1) * (size + 1) + at] == counts[at];
+				}
+			}
+			index = bot->order.items[bot->orderStart.items[component] + cell];
+			if (safe && !(board->tiles[index] & REVEALED_BIT)) {
+				sweepTile(board, index / board->stride, index % board->stride);
+				acted = TRUE;
+			}
+			else if (bomb && !(board->tiles[index] & (REVEALED_BIT | FLAGGED_BIT))) {
+				toggleFlag(board, index / board->stride, index % board->stride);
+				acted = TRUE;
+			}
+			else if (chance / arrangements < bestChance) {
+				bestChance = chance / arrangements;
+				best = index;
+			}
+		}
+	}
+
+	if (acted) {
+		return TRUE;
+	}
+	if (best < 0) {
+		return LOSE;
+	}
+	bot->guesses++;
+	return sweepTile(board, best / board->stride, best % board->stride);
+}
+
+/* Purpose: Plays a dealt board to the end from the first move at (row, col), through sweepTile() and toggleFlag()
+ *          and using only what a player could see: deduceAll() first, then probeFrontier() whenever it is stuck.
+ * Return:  WIN if every safe tile was uncovered, or LOSE if a guess hit a bomb.
+ */
+int playBot(Board* board, Bot* bot, int row, int col) {
+	int result = WIN;
+
+	bot->frontier.count = 0;
+	bot->entryCount = 0;
+	bot->poolCount = 0;
+	bot->guesses = 0;
+	startSolving(board);
+	if (sweepTile(board, row, col) == LOSE) {
+		result = LOSE;
+	}
+	while (result == WIN && board->safeRemaining > 0) {
+		deduceAll(board, &bot->frontier);
+		if (board->safeRemaining > 0 && probeFrontier(board, bot) == LOSE) {
+			result = LOSE;
+		}
+	}
+	stopSolving(board);
+	return result;
+}
+
+#define BENCH_GAMES 20000
+/* Purpose: Times playBot() on random boards started from the centre and prints how it did.
+ * Return:  Zero, or one if the board or bot could not be made.
+ */
+int benchmarkBot(int rows, int cols, int bombs) {
+	Board* board = newBoard(rows, cols, bombs);
+	Bot* bot = newBot();
+	int move[MOVE_LENGTH] = { 0 };
+	int game = 0, wins = 0;
+	long guesses = 0, moves = 0;
+	double seconds = 0;
+	struct timespec start, end;
+
+	if (board == NULL || bot == NULL) {
+		freeBoard(board);
+		freeBot(bot);
+		return 1;
+	}
+	board->random = (uint64_t)time(NULL);
+	move[MROW] = (rows + 1) / 2;
+	move[MCOL] = (cols + 1) / 2;
+	timespec_get(&start, TIME_UTC);
+	for (game = 0; game < BENCH_GAMES; game++) {
+		resetBoard(board);
+		newAnswer(board, move);
+		prepareHints(board);
+		wins += playBot(board, bot, move[MROW], move[MCOL]) == WIN;
+		guesses += bot->guesses;
+		moves += board->moves;
+	}
+	timespec_get(&end, TIME_UTC);
+	seconds = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	printf("%d bot game(s) of %dx%d with %d bombs:\n", game, rows, cols, bombs);
+	printf("  won:     %.2f%%\n", 100.0 * wins / game);
+	printf("  moves:   %.1f per game, %.2f of them guesses\n", (double)moves / game, (double)guesses / game);
+	printf("  speed:   %.0f games/s\n", game / seconds);
+	freeBoard(board);
+	freeBot(bot);
+	return 0;
+}
+
+/* Purpose: Chooses the first move of a simulated game by the job's policy.
+ */
+void placeFirstMove(const SimulationJob* job, Board* board, int move[]) {
+	if (job->firstMove == FIRST_CORNER) {
+		move[MROW] = 1;
+		move[MCOL] = 1;
+	}
+	else if (job->firstMove == FIRST_RANDOM) {
+		move[MROW] = randomCoordinate(&board->random, board->rows) + 1;
+		move[MCOL] = randomCoordinate(&board->random, board->cols) + 1;
+	}
+	else {
+		move[MROW] = (board->rows + 1) / 2;
+		move[MCOL] = (board->cols + 1) / 2;
+	}
+}
+
+#define SIMULATION_BATCH 256 /* Games a thread takes from the job at a time. */
+/* Purpose: Plays batches of games for simulateGames() through playBot() until none are left, on a board and bot
+ *          made once for the thread. Tallies stay in locals until the end, so threads share only the batch counter.
+ *          Each game is timed on its own, the end of one being the start of the next, so its time has a spread too.
+ * Return:  Zero, as thrd_start_t functions must.
+ */
+int simulationWorker(void* worker) {
+	SimulationWorker* self = worker;
+	SimulationJob* job = self->job;
+	Board* board = newBoard(job->rows, job->cols, job->bombs);
+	Bot* bot = newBot();
+	int move[MOVE_LENGTH] = { 0 };
+	int result = 0;
+	long game = 0, last = 0, games = 0, wins = 0;
+	long long moves = 0, movesSquared = 0, guesses = 0, guessesSquared = 0;
+	double seconds = 0, secondsSquared = 0, elapsed = 0;
+	char journalName[FILENAME_MAX] = { 0 };
+	struct timespec start, end;
+
+	self->failed = board == NULL || bot == NULL;
+	if (!self->failed && job->journalName != NULL) {
+		snprintf(journalName, sizeof(journalName), "%s.%d", job->journalName, self->thread);
+		board->journal = fopen(journalName, "wb");
+		self->failed = board->journal == NULL;
+	}
+	while (!self->failed && (game = atomic_fetch_add(&job->next, SIMULATION_BATCH)) < job->games) {
+		last = job->games - game < SIMULATION_BATCH ? job->games : game + SIMULATION_BATCH;
+		games += last - game;
+		timespec_get(&start, TIME_UTC);
+		for (; game < last; game++) {
+			resetBoard(board);
+			board->random = streamSeed(job->seed, (uint64_t)game);
+			placeFirstMove(job, board, move);
+			newAnswer(board, move);
+			prepareHints(board);
+			journalGame(board, streamSeed(job->seed, (uint64_t)game));
+			result = playBot(board, bot, move[MROW], move[MCOL]);
+			journalEnd(board, result);
+			wins += result == WIN;
+			moves += board->moves;
+			movesSquared += (long long)board->moves * board->moves;
+			guesses += bot->guesses;
+			guessesSquared += (long long)bot->guesses * bot->guesses;
+			timespec_get(&end, TIME_UTC);
+			elapsed = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+			seconds += elapsed;
+			secondsSquared += elapsed * elapsed;
+			start = end;
+		}
+	}
+
+	self->games = games;
+	self->wins = wins;
+	self->moves = moves;
+	self->movesSquared = movesSquared;
+	self->guesses = guesses;
+	self->guessesSquared = guessesSquared;
+	self->seconds = seconds;
+	self->secondsSquared = secondsSquared;
+	if (board != NULL && board->journal != NULL) {
+		fclose(board->journal);
+	}
+	freeBoard(board);
+	freeBot(bot);
+	return 0;
+}
+
+#define Z_95 1.959963984540054 /* Standard normal quantile for 95% confidence intervals. */
+/* Purpose: Returns the half-width of a 95% confidence interval for a mean, from a sum and a sum of squares.
+ */
+double meanInterval(double sum, double sumSquared, long count) {
+	double mean = sum / count;
+	double variance = count > 1 ? (sumSquared - mean * sum) / (count - 1) : 0;
+
+	return variance > 0 ? Z_95 * sqrt(variance / count) : 0;
+}
+
+/* Purpose: Plays games on every core with playBot() and prints the win rate, with a Wilson score interval,
+ *          and the moves, guesses and time taken per game, with normal intervals.
+ * Param:   seed - Master seed. Game n is dealt, and its first move placed, from streamSeed(seed, n) alone,
+ *                 so the results depend on nothing but the seed, not even the number of threads.
+ *          firstMove - FIRST_CENTRE, FIRST_CORNER or FIRST_RANDOM.
+ *          journalName - If not NULL, each thread journals the games it plays to this name followed by "." and its number.
+ * Return:  Zero, or one if a thread could not make its board, bot or journal.
+ */
+int simulateGames(int rows, int cols, int bombs, long games, uint64_t seed, int firstMove, const char* journalName) {
+	const char* firstMoveNames[] = { "centre", "corner", "random" };
+	SimulationJob job;
+	SimulationWorker workers[MAX_THREADS];
+	thrd_t handles[MAX_THREADS];
+	int threads = countCores(), started = 0, at = 0, failed = FALSE;
+	long wins = 0;
+	long long moves = 0, movesSquared = 0, guesses = 0, guessesSquared = 0;
+	double seconds = 0, secondsSquared = 0, wallSeconds = 0, rate = 0, centre = 0, spread = 0, scale = 0;
+	struct timespec start, end;
+
+	if (games < 1) {
+		return 1;
+	}
+	job.seed = seed;
+	job.rows = rows;
+	job.cols = cols;
+	job.bombs = bombs;
+	job.firstMove = firstMove;
+	job.games = games;
+	job.journalName = journalName;
+	atomic_init(&job.next, 0);
+	threads = threads > MAX_THREADS ? MAX_THREADS : threads;
+	memset(workers, 0, sizeof(workers));
+
+	timespec_get(&start, TIME_UTC);
+	for (started = 0; started < threads; started++) {
+		workers[started].job = &job;
+		workers[started].thread = started;
+		if (started > 0 && thrd_create(&handles[started], simulationWorker, &workers[started]) != thrd_success) {
+			break;
+		}
+	}
+	simulationWorker(&workers[0]);
+	for (at = 0; at < started; at++) {
+		if (at > 0) {
+			thrd_join(handles[at], NULL);
+		}
+		failed = failed || workers[at].failed;
+		wins += workers[at].wins;
+		moves += workers[at].moves;
+		movesSquared += workers[at].movesSquared;
+		guesses += workers[at].guesses;
+		guessesSquared += workers[at].guessesSquared;
+		seconds += workers[at].seconds;
+		secondsSquared += workers[at].secondsSquared;
+	}
+	timespec_get(&end, TIME_UTC);
+	wallSeconds = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	if (failed) {
+		return 1;
+	}
+
+	/* Below: The Wilson interval stays sensible for win rates near 0 or 1, where the normal one does not. */
+	rate = (double)wins / games;
+	scale = 1 + Z_95 * Z_95 / games;
+	centre = (rate + Z_95 * Z_95 / (2.0 * games)) / scale;
+	spread = Z_95 * sqrt(rate * (1 - rate) / games + Z_95 * Z_95 / (4.0 * games * games)) / scale;
+
+	printf("%ld simulated game(s) of %dx%d with %d bombs, first move %s, seed %llu, on %d thread(s):\n",
+		games, rows, cols, bombs, firstMoveNames[firstMove], (unsigned long long)seed, started);
+	printf("  won:     %.3f%% (95%% interval %.3f%% to %.3f%%)\n", 100 * rate, 100 * (centre - spread), 100 * (centre + spread));
+	printf("  moves:   %.2f +/- %.2f per game\n", (double)moves / games, meanInterval(moves, movesSquared, games));
+	printf("  guesses: %.3f +/- %.3f per game\n", (double)guesses / games, meanInterval(guesses, guessesSquared, games));
+	printf("  time:    %.1f +/- %.1f us per game on a thread, %.0f games/s in all\n",
+		1e6 * seconds / games, 1e6 * meanInterval(seconds, secondsSquared, games), games / wallSeconds);
+	return 0;
+}
+
+/* Purpose: Returns the character labelling a row or column on the border, counting from 0.
+ *          Past the alphabet, labels fall back to the last digit of the coordinate.
+ */
+char coordinateLabel(int index) {
+	if (index < ALPHABET_LENGTH) {
+		return index + 'A';
+	}
+	return index % 10 + '0';
+}
+
+#define WRONGFLAG_CHAR '#'
+/* Purpose: Returns the character the player sees for a tile.
+ *          Once the game is over, missed bombs show as FLAGGED_CHAR and incorrect flags as WRONGFLAG_CHAR.
+ */
+char tileChar(const Board* board, unsigned char tile) {
+	if (board->over && (tile & FLAGGED_BIT) && !(tile & MINE_BIT)) {
+		return WRONGFLAG_CHAR;
+	}
+	if ((tile & FLAGGED_BIT) || (board->over && (tile & MINE_BIT))) {
+		return FLAGGED_CHAR;
+	}
+	if (tile & REVEALED_BIT) {
+		return (tile & HINT_MASK) + '0';
+	}
+	return BLANK;
+}
+
+/* Purpose: Renders one row of the visible board, border included, into board->text.
+ * Return:  The rendered line, ending with a newline. It is overwritten by the next call.
+ */
+char* renderRow(const Board* board, int row) {
+	char* text = board->text;
+	int atCol = 0;
+
+	if (row == 0 || row == board->rows + 1) {
+		/* Below: Fills the top and bottom borders with coordinate values and the corners. */
+		text[0] = text[board->cols + 1] = CORNER;
+		for (atCol = 0; atCol < board->cols; atCol++) {
+			text[atCol + 1] = coordinateLabel(atCol);
+		}
+	}
+	else {
+		text[0] = text[board->cols + 1] = coordinateLabel(row - 1);
+		for (atCol = 1; atCol < board->cols + 1; atCol++) {
+			text[atCol] = tileChar(board, TILE(board, row, atCol));
+		}
+	}
+	text[board->cols + 2] = '\n';
+	text[board->cols + 3] = '\0';
+	return text;
+}
+
+/* Purpose: Prints the board to the screen.
+ */
+void printBoardToScreen(const Board* board) {
+	int row = 0;
+
+	printf("\n");
+	for (row = 0; row < board->rows + 2; row++) {
+		printf("%s", renderRow(board, row));
+	}
+	printf("\n");
+}
+
+/* Purpose: Called when player game is over to expose all bomb locations,
+            and then print the board to the screen.
+ * Return:  Number of bombs missed by player.
+ */
+int showAnswer(Board* board) {
+	int trueBombsRemaining = 0;
+	int atRow = 0, atCol = 0;
+
+	/* Count any true bomb location not flagged. Rendering takes care of marking them
+	   and any incorrect flags once board->over is set. */
+	for (atRow = 1; atRow < board->rows + 1; atRow++) {
+		for (atCol = 1; atCol < board->cols + 1; atCol++) {
+			if ((TILE(board, atRow, atCol) & (MINE_BIT | FLAGGED_BIT)) == MINE_BIT) {
+				trueBombsRemaining++;
+			}
+		}
+	}
+	board->over = TRUE;
+	printBoardToScreen(board);
+	return trueBombsRemaining;
+}
+
+/* Purpose: Loops through the main turn/move sequence until the player loses, wins, restarts, or quits.
+ * Return:  LOSE if the player uncovers a bomb, WIN once every safe tile is uncovered,
+ *          tentative WIN if the player uses all their flags first,
+ *          RESTART if the player wishes to quit the game and tell main() to start a new one, or
+ *          QUIT tell main() to exit the program.
+ */
+int playGame(Board* board, int move[]) {
+	int flagsRemaining = board->bombs - board->flags; /* What the player thinks is bombsRemaining. */
+	int gameState = 0;
+
+	/* Below: The first move may already have opened every safe tile. */
+	while (flagsRemaining > 0 && board->safeRemaining > 0) {
+		/* Print the board and get the user's move.*/
+		if (move[MSBO] != TRUE) {
+			printBoardToScreen(board);
+		}
+		printf("Bombs apparantly remaining: %d\n", flagsRemaining);
+		gameState = getMove(board, move);
+		if (gameState == RESTART || gameState == QUIT || gameState == LOSE) {
+			return gameState;
+		}
+		flagsRemaining += move[MACT];
+	}
+	/* Below: Return WIN as the result to main, for main to verify if it came from flags alone. */
+	return WIN;
+}
+
+#define FILENAME_MAX_LENGTH 20
+/* Purpose: Prompts the user for a string to use as a file name, opens a file with that name for writing,
+ *          prints the final board to the file along with the user's score and the number of true bombs remaining,
+ *          and closes the file.
+ */
+void saveBoardToFile(const Board* board, int score, int trueBombsRemaining) {
+	char fileName[FILENAME_MAX_LENGTH] = { 0 };
+	int row = 0;
+
+	printf("Please enter a name for your file no longer than %d characters: ", FILENAME_MAX_LENGTH - 1);
+	scanf("%19s", fileName);
+
+	FILE* saveFile;
+	saveFile = fopen(fileName, "w");
+	if (saveFile == NULL) {
+		printf("Error: Could not open file for saving. Giving up on saving your file...\n\n");
+	}
+	else {
+		for (row = 0; row < board->rows + 2; row++) {
+			fprintf(saveFile, "%s", renderRow(board, row));
+		}
+		fprintf(saveFile, "\nScore: %d seconds\nBombs remaining: %d", score, trueBombsRemaining);
+		fclose(saveFile);
 		printf("Your textfile was successfully saved in this project's directory!\n\n");
 	}
 }
 
+/* Purpose: Appends an unsigned number to a journal as a varint: seven bits a byte, low bits first,
+ *          with the top bit set on every byte but the last.
+ */
+void writeVarint(FILE* file, uint64_t value) {
+	while (value >= 0x80) {
+		putc((int)(value & 0x7F) | 0x80, file);
+		value >>= 7;
+	}
+	putc((int)value, file);
+}
+
+#define JOURNAL_MAGIC "MSJ1"
+#define MAGIC_LENGTH 4
+/* Purpose: Starts a game in the board's journal, if it has one, with its dimensions, the seed it was dealt from
+ *          and its layout, one bit per tile row by row, so it replays the same however the bombs were placed.
+ */
+void journalGame(Board* board, uint64_t seed) {
+	int atRow = 0, atCol = 0, bit = 0, byte = 0, shift = 0;
+
+	if (board->journal == NULL) {
+		return;
+	}
+	fwrite(JOURNAL_MAGIC, 1, MAGIC_LENGTH, board->journal);
+	writeVarint(board->journal, (uint64_t)board->rows);
+	writeVarint(board->journal, (uint64_t)board->cols);
+	writeVarint(board->journal, (uint64_t)board->bombs);
+	for (shift = 0; shift < 64; shift += 8) {
+		putc((int)(seed >> shift & 0xFF), board->journal);
+	}
+	for (atRow = 1; atRow < board->rows + 1; atRow++) {
+		for (atCol = 1; atCol < board->cols + 1; atCol++) {
+			byte |= ((TILE(board, atRow, atCol) & MINE_BIT) != 0) << bit;
+			if (++bit == 8) {
+				putc(byte, board->journal);
+				bit = byte = 0;
+			}
+		}
+	}
+	if (bit > 0) {
+		putc(byte, board->journal);
+	}
+}
+
+/* Purpose: Appends a move to the board's journal, if it has one, as one varint of the tile counted row by row
+ *          from the top left, times four, plus the JOURNAL_ action. Flushes it too if board->journalFlush is set.
+ */
+void journalMove(Board* board, int action, int row, int col) {
+	if (board->journal != NULL) {
+		writeVarint(board->journal, ((uint64_t)(row - 1) * board->cols + (col - 1)) << 2 | (uint64_t)action);
+		if (board->journalFlush) {
+			fflush(board->journal);
+		}
+	}
+}
+
+/* Purpose: Ends the game in the board's journal, if it has one, recording how it ended (WIN, LOSE, RESTART, or QUIT
+ *          if it is only suspended), and makes sure everything so far has reached the file.
+ */
+void journalEnd(Board* board, int result) {
+	if (board->journal != NULL) {
+		writeVarint(board->journal, (uint64_t)result << 2 | JOURNAL_END);
+		fflush(board->journal);
+	}
+}
+
+/* Purpose: Reads a whole journal file into memory, so it can be decoded without a library call per byte.
+ * Return:  TRUE on success, or FALSE if it could not be read, having said why.
+ */
+int loadJournal(Journal* journal, const char* fileName) {
+	FILE* file = fopen(fileName, "rb");
+	size_t length = 0;
+	unsigned char* grown = NULL;
+
+	journal->data = NULL;
+	journal->size = journal->at = 0;
+	if (file == NULL) {
+		printf("Error: Could not open the journal %s.\n", fileName);
+		return FALSE;
+	}
+	do {
+		length = length < MIN_PENDING ? MIN_PENDING : 2 * length;
+		grown = realloc(journal->data, length);
+		if (grown == NULL) {
+			printf("Error: Not enough memory to load the journal %s.\n", fileName);
+			free(journal->data);
+			fclose(file);
+			return FALSE;
+		}
+		journal->data = grown;
+		journal->size += fread(&journal->data[journal->size], 1, length - journal->size, file);
+	} while (journal->size == length);
+	fclose(file);
+	return TRUE;
+}
+
+/* Purpose: Reads the next varint of a journal.
+ * Return:  TRUE on success, or FALSE if the journal ends first or the number overflows.
+ */
+int readVarint(Journal* journal, uint64_t* value) {
+	int shift = 0;
+
+	*value = 0;
+	for (shift = 0; shift < 64 && journal->at < journal->size; shift += 7) {
+		*value |= (uint64_t)(journal->data[journal->at] & 0x7F) << shift;
+		if (!(journal->data[journal->at++] & 0x80)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* Purpose: Returns TRUE if the next bytes of a journal start a game.
+ */
+int atGameStart(const Journal* journal) {
+	return journal->size - journal->at >= MAGIC_LENGTH && memcmp(&journal->data[journal->at], JOURNAL_MAGIC, MAGIC_LENGTH) == 0;
+}
+
+/* Purpose: Reads the start of the next game in a journal, and deals it onto the board, making a new board
+ *          if the one given is missing or the wrong size.
+ * Return:  TRUE on success, or FALSE at the end of the journal or if the header is broken.
+ */
+int readJournalGame(Journal* journal, Board** board, uint64_t* seed) {
+	uint64_t rows = 0, cols = 0, bombs = 0;
+	int atRow = 0, atCol = 0, bit = 0, placed = 0, shift = 0;
+	const unsigned char* layout = NULL;
+
+	if (!atGameStart(journal)) {
+		return FALSE;
+	}
+	journal->at += MAGIC_LENGTH;
+	if (!readVarint(journal, &rows) || !readVarint(journal, &cols) || !readVarint(journal, &bombs) ||
+		rows < 1 || rows > MAX_DIMENSION || cols < 1 || cols > MAX_DIMENSION || bombs >= rows * cols ||
+		journal->size - journal->at < 8 + (rows * cols + 7) / 8) {
+		return FALSE;
+	}
+	for (*seed = 0, shift = 0; shift < 64; shift += 8) {
+		*seed |= (uint64_t)journal->data[journal->at++] << shift;
+	}
+	if (*board == NULL || (*board)->rows != (int)rows || (*board)->cols != (int)cols || (*board)->bombs != (int)bombs) {
+		freeBoard(*board);
+		*board = newBoard((int)rows, (int)cols, (int)bombs);
+		if (*board == NULL) {
+			return FALSE;
+		}
+	}
+
+	layout = &journal->data[journal->at];
+	journal->at += (rows * cols + 7) / 8;
+	resetBoard(*board);
+	for (atRow = 1; atRow < (int)rows + 1; atRow++) {
+		for (atCol = 1; atCol < (int)cols + 1; atCol++, bit++) {
+			if (layout[bit / 8] >> bit % 8 & 1) {
+				TILE(*board, atRow, atCol) |= MINE_BIT;
+				placed++;
+			}
+		}
+	}
+	(*board)->safeRemaining = (int)(rows * cols) - placed;
+	prepareHints(*board);
+	return placed == (int)bombs;
+}
+
+/* Purpose: Plays the moves of the game just read by readJournalGame() on the board, through the same calls a player's
+ *          moves go through, up to its end or the end of the journal.
+ * Param:   recorded - Gets how the journal says the game ended (QUIT if it was suspended), or -1 if it does not say.
+ * Return:  LOSE if a move hit a bomb, WIN if the game was won as main() would judge it, QUIT if it was left
+ *          unfinished, or -1 if the moves are broken.
+ */
+int replayMoves(Journal* journal, Board* board, int* recorded) {
+	const uint64_t tiles = (uint64_t)board->rows * board->cols;
+	uint64_t value = 0;
+	int result = QUIT, row = 0, col = 0, atRow = 0, atCol = 0, missed = 0;
+
+	*recorded = -1;
+	while (journal->at < journal->size && readVarint(journal, &value)) {
+		if ((value & 3) == JOURNAL_END) {
+			*recorded = (int)(value >> 2);
+			/* Below: A game quit from is only suspended, and goes on if more moves follow before the next game. */
+			if (*recorded != QUIT || journal->at == journal->size || atGameStart(journal)) {
+				break;
+			}
+			*recorded = -1;
+			continue;
+		}
+		if (value >> 2 >= tiles || result == LOSE) {
+			return -1;
+		}
+		row = (int)((value >> 2) / board->cols) + 1;
+		col = (int)((value >> 2) % board->cols) + 1;
+		if ((value & 3) == JOURNAL_SWEEP) {
+			result = sweepTile(board, row, col) == LOSE ? LOSE : result;
+		}
+		else if ((value & 3) == JOURNAL_RING_SWEEP) {
+			result = ringSweep(board, row, col) == LOSE ? LOSE : result;
+		}
+		else if (!(TILE(board, row, col) & REVEALED_BIT)) {
+			toggleFlag(board, row, col);
+		}
+	}
+
+	/* Below: Like main(), a game whose flags are all placed is won if they cover every bomb, and lost otherwise. */
+	if (result != LOSE && board->safeRemaining > 0 && board->flags == board->bombs) {
+		for (atRow = 1; atRow < board->rows + 1; atRow++) {
+			for (atCol = 1; atCol < board->cols + 1; atCol++) {
+				missed += (TILE(board, atRow, atCol) & (MINE_BIT | FLAGGED_BIT)) == MINE_BIT;
+			}
+		}
+		result = missed ? LOSE : WIN;
+	}
+	return result != LOSE && board->safeRemaining == 0 ? WIN : result;
+}
+
+/* Purpose: Replays every game of a journal without rendering anything, as fast as the engine goes,
+ *          and prints how many there were, whether each ended as recorded, and how fast it went.
+ * Return:  Zero, or one if the journal could not be read, is broken, or replayed differently than recorded.
+ */
+int replayJournal(const char* fileName) {
+	Journal journal;
+	Board* board = NULL;
+	uint64_t seed = 0;
+	long games = 0, wins = 0, moves = 0, mismatches = 0, broken = 0;
+	int result = 0, recorded = 0;
+	double seconds = 0;
+	struct timespec start, end;
+
+	if (!loadJournal(&journal, fileName)) {
+		return 1;
+	}
+	timespec_get(&start, TIME_UTC);
+	while (readJournalGame(&journal, &board, &seed)) {
+		result = replayMoves(&journal, board, &recorded);
+		games++;
+		wins += result == WIN;
+		moves += board->moves;
+		broken += result < 0;
+		mismatches += (recorded == WIN || recorded == LOSE) && recorded != result;
+	}
+	timespec_get(&end, TIME_UTC);
+	seconds = (double)(end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+	broken += journal.at < journal.size;
+
+	printf("Replayed %ld game(s) and %ld move(s) from %s in %.3f s (%.0f moves/s):\n", games, moves, fileName, seconds, moves / seconds);
+	printf("  won:        %ld\n", wins);
+	printf("  mismatches: %ld game(s) ended differently than recorded\n", mismatches);
+	if (broken) {
+		printf("  The journal is broken after %zu of its %zu bytes.\n", journal.at, journal.size);
+	}
+	freeBoard(board);
+	free(journal.data);
+	return mismatches || broken;
+}
+
+/* Purpose: Puts the last game of a journal back on the board if it was quit from or cut off, so it can be played on.
+ * Return:  The board holding it, or NULL (with the board given released) if every game in the journal ended.
+ */
+Board* resumeJournal(const char* fileName, Board* board) {
+	Journal journal;
+	uint64_t seed = 0;
+	int result = 0, recorded = 0;
+
+	if (!loadJournal(&journal, fileName)) {
+		freeBoard(board);
+		return NULL;
+	}
+	while (readJournalGame(&journal, &board, &seed)) {
+		result = replayMoves(&journal, board, &recorded);
+	}
+	free(journal.data);
+	if (board != NULL && ((recorded >= 0 && recorded != QUIT) || result != QUIT)) {
+		freeBoard(board);
+		board = NULL;
+	}
+	return board;
+}
+
+/* Purpose: Appends formatted text to a client's output, growing it as needed.
+ * Return:  TRUE on success, or FALSE if there is no memory left for it.
+ */
+int appendText(Client* client, const char* format, ...) {
+	va_list arguments;
+	size_t length = 0;
+	char* grown = NULL;
+	int written = 0;
+
+	va_start(arguments, format);
+	written = vsnprintf(NULL, 0, format, arguments);
+	va_end(arguments);
+	if (written < 0) {
+		return FALSE;
+	}
+	if (client->outputCount + written + 1 > client->outputLength) {
+		length = client->outputLength < MIN_PENDING ? MIN_PENDING : client->outputLength;
+		while (length < client->outputCount + written + 1) {
+			length *= 2;
+		}
+		grown = realloc(client->output, length);
+		if (grown == NULL) {
+			return FALSE;
+		}
+		client->output = grown;
+		client->outputLength = length;
+	}
+	va_start(arguments, format);
+	vsnprintf(&client->output[client->outputCount], (size_t)written + 1, format, arguments);
+	va_end(arguments);
+	client->outputCount += written;
+	return TRUE;
+}
+
+/* Purpose: Returns the name a session's state goes by in the protocol.
+ */
+const char* stateName(const Session* session) {
+	return session->state == WIN ? "WON" : session->state == LOSE ? "LOST" : "PLAYING";
+}
+
+/* Purpose: Finds the session a command names, if it exists and belongs to the client.
+ * Return:  The session, or NULL, having told the client why.
+ */
+Session* findSession(Server* server, Client* client, int id) {
+	if (id < 0 || id >= server->count || server->sessions[id].board == NULL || server->sessions[id].owner != client) {
+		appendText(client, "E %d no such game\n", id);
+		return NULL;
+	}
+	return &server->sessions[id];
+}
+
+/* Purpose: Ends a session, releasing its board and keeping its number for the next new game.
+ */
+void closeSession(Server* server, int id) {
+	freeBoard(server->sessions[id].board);
+	server->sessions[id].board = NULL;
+	server->sessions[id].owner = NULL;
+	pushInt(&server->freeIds, id);
+}
+
+/* Purpose: Makes a move in a session and tells the client only the tiles it changed, from the board's change log.
+ *          The bombs are placed around the first move, which must be a sweep, like in the interactive game.
+ */
+void moveSession(Server* server, Client* client, Session* session, int id, char action, int row, int col) {
+	Board* board = session->board;
+	int move[MOVE_LENGTH] = { 0 };
+	int result = TRUE, at = 0, index = 0;
+	unsigned char tile = 0;
+
+	if (session->state != PLAYING) {
+		appendText(client, "E %d game is over\n", id);
+		return;
+	}
+	if (row < 1 || row > board->rows || col < 1 || col > board->cols) {
+		appendText(client, "E %d coordinates out of range\n", id);
+		return;
+	}
+	tile = TILE(board, row, col);
+	if ((action == SWEEP_CHAR && (tile & (REVEALED_BIT | FLAGGED_BIT))) || (action == RING_SWEEP_CHAR && !(tile & REVEALED_BIT)) ||
+		(action == FLAG_CHAR && (tile & REVEALED_BIT)) || (action != SWEEP_CHAR && action != RING_SWEEP_CHAR && action != FLAG_CHAR) ||
+		(action != SWEEP_CHAR && !session->dealt)) {
+		appendText(client, "E %d move not allowed\n", id);
+		return;
+	}
+
+	if (!session->dealt) {
+		move[MROW] = row;
+		move[MCOL] = col;
+		board->random = streamSeed(server->seed, server->games++);
+		newAnswer(board, move);
+		prepareHints(board);
+		session->dealt = TRUE;
+	}
+	board->changes.count = 0;
+	if (action == SWEEP_CHAR) {
+		result = sweepTile(board, row, col);
+	}
+	else if (action == RING_SWEEP_CHAR) {
+		result = ringSweep(board, row, col);
+	}
+	else {
+		toggleFlag(board, row, col);
+	}
+	session->state = result == LOSE ? LOSE : board->safeRemaining == 0 ? WIN : PLAYING;
+	board->over = session->state != PLAYING;
+
+	appendText(client, "C %d %s %d", id, stateName(session), board->changes.count);
+	for (at = 0; at < board->changes.count; at++) {
+		index = board->changes.items[at];
+		appendText(client, " %d.%d=%c", index / board->stride, index % board->stride, tileChar(board, board->tiles[index]));
+	}
+	appendText(client, "\n");
+	board->changes.count = 0;
+}
+
+#define NEW_COMMAND 'N'
+#define MOVE_COMMAND 'M'
+#define QUERY_COMMAND 'Q'
+#define STATE_COMMAND 'S'
+#define CLOSE_COMMAND 'X'
+/* Purpose: Carries out one line of the server protocol from a client and queues the reply. Coordinates count from 1.
+ *          N rows cols bombs          -> G id                  Starts a game.
+ *          M id action row col        -> C id state n row.col=c ...  Moves (action S, D or F, as in the game),
+ *                                                              replying with the n tiles that changed.
+ *          Q id row col height width  -> R id row col height width chars  Shows a block of tiles row by row.
+ *          S id                       -> S id state rows cols bombs flags covered moves
+ *          X id                       -> X id                  Ends a game.
+ *          Anything wrong gets E, the game number where there is one, and the reason.
+ */
+void handleCommand(Server* server, Client* client, const char* line) {
+	Session* session = NULL;
+	Board* board = NULL;
+	void* grown = NULL;
+	char action = 0;
+	int id = 0, row = 0, col = 0, height = 0, width = 0, bombs = 0, atRow = 0;
+
+	if (line[0] == NEW_COMMAND && sscanf(line + 1, "%d %d %d", &row, &col, &bombs) == 3) {
+		/* Below: The same limits as newBoard(), which would print its complaint onto the protocol stream. */
+		if (row < 1 || row > MAX_DIMENSION || col < 1 || col > MAX_DIMENSION || bombs < 1 || (long long)row * col - SPAWN_AREA < bombs) {
+			appendText(client, "E -1 bad dimensions\n");
+			return;
+		}
+		board = allocateBoard(row, col, bombs);
+		grown = growArray(server->sessions, &server->length, (size_t)server->count + 1, sizeof(Session));
+		if (board == NULL || grown == NULL) {
+			freeBoard(board);
+			appendText(client, "E -1 out of memory\n");
+			return;
+		}
+		server->sessions = grown;
+		id = server->freeIds.count > 0 ? server->freeIds.items[--server->freeIds.count] : server->count++;
+		session = &server->sessions[id];
+		session->board = board;
+		session->owner = client;
+		session->state = PLAYING;
+		session->dealt = FALSE;
+		resetBoard(board);
+		board->logging = TRUE;
+		appendText(client, "G %d\n", id);
+	}
+	else if (line[0] == MOVE_COMMAND && sscanf(line + 1, "%d %c %d %d", &id, &action, &row, &col) == 4) {
+		if ((session = findSession(server, client, id)) != NULL) {
+			moveSession(server, client, session, id, action, row, col);
+		}
+	}
+	else if (line[0] == QUERY_COMMAND && sscanf(line + 1, "%d %d %d %d %d", &id, &row, &col, &height, &width) == 5) {
+		if ((session = findSession(server, client, id)) == NULL) {
+			return;
+		}
+		board = session->board;
+		if (row < 1 || col < 1 || height < 1 || width < 1 || height > board->rows - row + 1 || width > board->cols - col + 1) {
+			appendText(client, "E %d block out of range\n", id);
+			return;
+		}
+		appendText(client, "R %d %d %d %d %d ", id, row, col, height, width);
+		for (atRow = row; atRow < row + height; atRow++) {
+			appendText(client, "%.*s", width, &renderRow(board, atRow)[col]);
+		}
+		appendText(client, "\n");
+	}
+	else if (line[0] == STATE_COMMAND && sscanf(line + 1, "%d", &id) == 1) {
+		if ((session = findSession(server, client, id)) != NULL) {
+			board = session->board;
+			appendText(client, "S %d %s %d %d %d %d %d %d\n", id, stateName(session), board->rows, board->cols, board->bombs,
+				board->flags, session->dealt ? board->safeRemaining : board->rows * board->cols - board->bombs, board->moves);
+		}
+	}
+	else if (line[0] == CLOSE_COMMAND && sscanf(line + 1, "%d", &id) == 1) {
+		if (findSession(server, client, id) != NULL) {
+			closeSession(server, id);
+			appendText(client, "X %d\n", id);
+		}
+	}
+	else {
+		appendText(client, "E -1 unknown command\n");
+	}
+}
+
+/* Purpose: Ends every session a client started, once it has gone.
+ */
+void dropSessions(Server* server, const Client* client) {
+	int id = 0;
+
+	for (id = 0; id < server->count; id++) {
+		if (server->sessions[id].board != NULL && server->sessions[id].owner == client) {
+			closeSession(server, id);
+		}
+	}
+}
+
+#define MAX_LINE 256 /* Longest command line, newline included. */
+/* Purpose: Serves one client on standard input and output until input ends.
+ * Return:  Zero.
+ */
+int serveStream(Server* server) {
+	Client client;
+	char line[MAX_LINE] = { 0 };
+
+	memset(&client, 0, sizeof(client));
+	client.fd = -1;
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		handleCommand(server, &client, line);
+		fwrite(client.output, 1, client.outputCount, stdout);
+		fflush(stdout);
+		client.outputCount = 0;
+	}
+	dropSessions(server, &client);
+	free(client.output);
+	return 0;
+}
+
+#ifdef __linux__
+#define MAX_EVENTS 64
+/* Purpose: Sends as much of a client's queued output as the socket takes without blocking, and asks epoll to say
+ *          when it can take more if some is left.
+ * Return:  TRUE, or FALSE if the connection has failed.
+ */
+int flushClient(int poller, Client* client) {
+	struct epoll_event event;
+	ssize_t sent = 0;
+	size_t done = 0;
+
+	while (done < client->outputCount) {
+		sent = send(client->fd, &client->output[done], client->outputCount - done, MSG_NOSIGNAL);
+		if (sent < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				break;
+			}
+			return FALSE;
+		}
+		done += (size_t)sent;
+	}
+	memmove(client->output, &client->output[done], client->outputCount - done);
+	client->outputCount -= done;
+
+	event.events = EPOLLIN | (client->outputCount > 0 ? EPOLLOUT : 0);
+	event.data.ptr = client;
+	return epoll_ctl(poller, EPOLL_CTL_MOD, client->fd, &event) == 0;
+}
+
+/* Purpose: Disconnects a client, ending its sessions.
+ */
+void dropClient(Server* server, int poller, Client* client) {
+	epoll_ctl(poller, EPOLL_CTL_DEL, client->fd, NULL);
+	close(client->fd);
+	dropSessions(server, client);
+	free(client->input);
+	free(client->output);
+	free(client);
+}
+
+/* Purpose: Reads whatever a client has sent and carries out each complete line of it.
+ * Return:  TRUE, or FALSE if the client has gone or sent a line longer than MAX_LINE.
+ */
+int readClient(Server* server, Client* client) {
+	ssize_t received = 0;
+	char* end = NULL;
+	char* start = NULL;
+
+	if (client->input == NULL && (client->input = malloc(MAX_LINE)) == NULL) {
+		return FALSE;
+	}
+	for (;;) {
+		received = recv(client->fd, &client->input[client->inputCount], MAX_LINE - client->inputCount, 0);
+		if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+			return FALSE;
+		}
+		if (received < 0) {
+			return TRUE;
+		}
+		client->inputCount += (size_t)received;
+
+		/* Below: Carries out every finished line, and keeps the unfinished rest for the next read. */
+		start = client->input;
+		while ((end = memchr(start, '\n', client->inputCount - (size_t)(start - client->input))) != NULL) {
+			*end = '\0';
+			handleCommand(server, client, start);
+			start = end + 1;
+		}
+		client->inputCount -= (size_t)(start - client->input);
+		memmove(client->input, start, client->inputCount);
+		if (client->inputCount == MAX_LINE) {
+			return FALSE;
+		}
+	}
+}
+
+/* Purpose: Serves any number of clients on a Unix-domain socket at path, multiplexed by epoll on this one thread,
+ *          until it fails.
+ * Note:    Every socket is non-blocking, so a slow client only ever makes its own replies wait.
+ * Return:  One, after saying what failed.
+ */
+int serveSocket(Server* server, const char* path) {
+	struct sockaddr_un address;
+	struct epoll_event event, events[MAX_EVENTS];
+	Client* client = NULL;
+	int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+	int poller = epoll_create1(0);
+	int ready = 0, at = 0, fd = 0;
+
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(path) >= sizeof(address.sun_path)) {
+		printf("Error: The socket path %s is too long.\n", path);
+		return 1;
+	}
+	strcpy(address.sun_path, path);
+	unlink(path);
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+	if (listener < 0 || poller < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+		listen(listener, SOMAXCONN) != 0 || epoll_ctl(poller, EPOLL_CTL_ADD, listener, &event) != 0) {
+		printf("Error: Could not listen on %s: %s\n", path, strerror(errno));
+		return 1;
+	}
+	printf("Serving games on %s.\n", path);
+	fflush(stdout);
+
+	for (;;) {
+		ready = epoll_wait(poller, events, MAX_EVENTS, -1);
+		if (ready < 0 && errno != EINTR) {
+			printf("Error: Waiting on clients failed: %s\n", strerror(errno));
+			return 1;
+		}
+		for (at = 0; at < ready; at++) {
+			client = events[at].data.ptr;
+
+			/* Below: A new client, or several, on the listening socket. */
+			if (client == NULL) {
+				while ((fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK)) >= 0) {
+					client = calloc(1, sizeof(Client));
+					event.events = EPOLLIN;
+					event.data.ptr = client;
+					if (client != NULL) {
+						client->fd = fd;
+					}
+					if (client == NULL || epoll_ctl(poller, EPOLL_CTL_ADD, fd, &event) != 0) {
+						free(client);
+						close(fd);
+					}
+				}
+				continue;
+			}
+			if ((events[at].events & (EPOLLERR | EPOLLHUP)) && !(events[at].events & EPOLLIN)) {
+				dropClient(server, poller, client);
+			}
+			else if (((events[at].events & EPOLLIN) && !readClient(server, client)) || !flushClient(poller, client)) {
+				dropClient(server, poller, client);
+			}
+		}
+	}
+}
+#endif
+
+/* Purpose: Hosts many independent games in this one process for bots and other programs, over the line protocol of
+ *          handleCommand(), on standard input and output or, given a path, on a Unix-domain socket.
+ * Return:  Zero, or one if the server could not run.
+ */
+int serveGames(const char* path, uint64_t seed) {
+	Server server;
+	int result = 0, id = 0;
+
+	memset(&server, 0, sizeof(server));
+	server.seed = seed;
+	if (path == NULL) {
+		result = serveStream(&server);
+	}
+	else {
+#ifdef __linux__
+		result = serveSocket(&server, path);
+#else
+		printf("Error: Serving on a socket needs Linux. Leave out the path to serve on standard input and output.\n");
+		result = 1;
+#endif
+	}
+	for (id = 0; id < server.count; id++) {
+		freeBoard(server.sessions[id].board);
+	}
+	free(server.sessions);
+	free(server.freeIds.items);
+	return result;
+}
+
 /* Debug functions. */
-void printIntegerArray(int hints[][NCOLS + 2]) {
+void printTileArray(const Board* board, int mask, int shift) {
 	int atRow = 0, atCol = 0;
 
-	for (atRow = 0; atRow < NROWS + 2; atRow++) {
-		for (atCol = 0; atCol < NCOLS + 2; atCol++) {
-			printf("%d", hints[atRow][atCol]);
+	for (atRow = 0; atRow < board->rows + 2; atRow++) {
+		for (atCol = 0; atCol < board->cols + 2; atCol++) {
+			printf("%d", (TILE(board, atRow, atCol) & mask) >> shift);
 		}
 		printf("\n");
 	}